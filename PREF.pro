@@ -2,8 +2,10 @@ TEMPLATE = subdirs
 
 pref_ui.file = PREF/PREF.pro
 preflib.file = PrefLib/PrefLib.pro
+bench.file = bench/bench.pro
 
 PREF.depends = preflib pref_ui
+bench.depends = preflib
 
 CONFIG += ordered
-SUBDIRS = preflib pref_ui
+SUBDIRS = preflib pref_ui bench
@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui
+QT       += core gui concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -30,6 +30,7 @@ DEFINES += GIT_VERSION='\\\"'$$system("git rev-parse --short HEAD")'\\\"'
 SOURCES += main.cpp\
         mainwindow.cpp \
     platform/loadeddata.cpp \
+    platform/mappedfile.cpp \
     widgets/binarynavigator.cpp \
     widgets/views/abstractview.cpp \
     widgets/views/binaryview.cpp \
@@ -37,9 +38,9 @@ SOURCES += main.cpp\
     widgets/visualmap/viewmodes/dotplotviewmode.cpp \
     widgets/visualmap/viewmodes/pixelviewmode.cpp \
     widgets/visualmap/visualmap.cpp \
+    widgets/visualmap/visualmaprenderer.cpp \
     models/datainspectormodel.cpp \
     models/basicmodel.cpp \
-    platform/chartworker.cpp \
     widgets/chart/qhistogram.cpp \
     widgets/chart/chartcontainer.cpp \
     widgets/chart/qxychart.cpp \
@@ -47,16 +48,40 @@ SOURCES += main.cpp\
     widgets/tabs/stringstab.cpp \
     models/stringsmodel.cpp \
     platform/basicworker.cpp \
-    platform/stringsworker.cpp \
     models/templatemodel.cpp \
     platform/btvmex.cpp \
     dialogs/scalardialog.cpp \
     widgets/logwidget/logwidget.cpp \
     widgets/logwidget/loghighlighter.cpp \
-    dialogs/aboutdialog.cpp
+    dialogs/aboutdialog.cpp \
+    platform/analysis/analysisworker.cpp \
+    platform/analysis/analysisscheduler.cpp \
+    platform/analysis/analysisconsumer.cpp \
+    platform/analysis/bytecountconsumer.cpp \
+    platform/analysis/windowconsumer.cpp \
+    platform/analysis/entropyconsumer.cpp \
+    platform/analysis/categorymapconsumer.cpp \
+    platform/analysis/stringsconsumer.cpp \
+    platform/analysis/bytecounter.cpp \
+    platform/analysis/byteclassifier.cpp \
+    platform/analysis/stringscanner.cpp \
+    platform/analysis/stringarena.cpp \
+    platform/analysis/stringindex.cpp \
+    platform/stringsfilterworker.cpp \
+    platform/datadecoder.cpp \
+    platform/templateworker.cpp \
+    platform/highlighttable.cpp \
+    platform/templateresult.cpp \
+    platform/templatecache.cpp \
+    platform/templaterunner.cpp \
+    platform/templateexporter.cpp \
+    platform/arrayview.cpp \
+    platform/templateprofiler.cpp \
+    models/profilemodel.cpp
 
 HEADERS  += mainwindow.h \
     platform/loadeddata.h \
+    platform/mappedfile.h \
     widgets/binarynavigator.h \
     widgets/views/abstractview.h \
     widgets/views/binaryview.h \
@@ -64,9 +89,9 @@ HEADERS  += mainwindow.h \
     widgets/visualmap/viewmodes/dotplotviewmode.h \
     widgets/visualmap/viewmodes/pixelviewmode.h \
     widgets/visualmap/visualmap.h \
+    widgets/visualmap/visualmaprenderer.h \
     models/datainspectormodel.h \
     models/basicmodel.h \
-    platform/chartworker.h \
     widgets/chart/qhistogram.h \
     widgets/chart/chartcontainer.h \
     widgets/chart/qxychart.h \
@@ -74,13 +99,44 @@ HEADERS  += mainwindow.h \
     widgets/tabs/stringstab.h \
     models/stringsmodel.h \
     platform/basicworker.h \
-    platform/stringsworker.h \
     models/templatemodel.h \
     platform/btvmex.h \
     dialogs/scalardialog.h \
     widgets/logwidget/logwidget.h \
     widgets/logwidget/loghighlighter.h \
-    dialogs/aboutdialog.h
+    dialogs/aboutdialog.h \
+    platform/analysis/analysisworker.h \
+    platform/analysis/analysisscheduler.h \
+    platform/analysis/analysisconsumer.h \
+    platform/analysis/bytecountconsumer.h \
+    platform/analysis/windowconsumer.h \
+    platform/analysis/entropyconsumer.h \
+    platform/analysis/categorymapconsumer.h \
+    platform/analysis/stringsconsumer.h \
+    platform/analysis/bytecounter.h \
+    platform/analysis/byteclassifier.h \
+    platform/analysis/stringscanner.h \
+    platform/analysis/stringarena.h \
+    platform/analysis/stringindex.h \
+    platform/stringsfilterworker.h \
+    platform/datadecoder.h \
+    platform/templateworker.h \
+    platform/highlighttable.h \
+    platform/templateresult.h \
+    platform/templatecache.h \
+    platform/templaterunner.h \
+    platform/templateexporter.h \
+    platform/arrayview.h \
+    platform/templateprofiler.h \
+    models/profilemodel.h
+
+contains(QT_ARCH, x86_64)|contains(QT_ARCH, i386) {
+    CONFIG += simd
+    DEFINES += PREF_SIMD_X86
+
+    SSE4_1_SOURCES += platform/analysis/byteclassifier_sse41.cpp
+    AVX2_SOURCES += platform/analysis/byteclassifier_avx2.cpp
+}
 
 FORMS  += mainwindow.ui \
     widgets/views/binaryview.ui \
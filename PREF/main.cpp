@@ -1,8 +1,79 @@
 #include "mainwindow.h"
+#include "platform/templaterunner.h"
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QThreadPool>
+#include <QFile>
+#include <cstring>
+#include <cstdio>
+
+static bool isHeadless(int argc, char *argv[])
+{
+    for(int i = 1; i < argc; i++)
+    {
+        if(!std::strcmp(argv[i], "-t") || !std::strcmp(argv[i], "--template"))
+            return true;
+    }
+
+    return false;
+}
+
+static int runHeadless(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv); /* No display needed */
+    a.setApplicationName("PREF");
+    a.setApplicationVersion(QString("3.0-") + GIT_VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Applies an 010 Editor template to files and writes the results as JSON Lines");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption templateoption(QStringList() << "t" << "template", "Template to apply.", "template");
+    QCommandLineOption listoption(QStringList() << "l" << "list", "Read file names from <list>, one per line.", "list");
+    QCommandLineOption jobsoption(QStringList() << "j" << "jobs", "Number of files processed in parallel.", "jobs");
+    parser.addOption(templateoption);
+    parser.addOption(listoption);
+    parser.addOption(jobsoption);
+    parser.addPositionalArgument("files", "Files or wildcard patterns.", "[files...]");
+    parser.process(a);
+
+    QStringList files = TemplateRunner::expandFiles(parser.positionalArguments());
+
+    if(parser.isSet(listoption))
+    {
+        QFile listfile(parser.value(listoption));
+
+        if(!listfile.open(QFile::ReadOnly | QFile::Text))
+        {
+            std::fprintf(stderr, "Cannot open %s\n", qPrintable(listfile.fileName()));
+            return 2;
+        }
+
+        while(!listfile.atEnd())
+        {
+            QString file = QString::fromLocal8Bit(listfile.readLine()).trimmed();
+
+            if(!file.isEmpty())
+                files.append(file);
+        }
+    }
+
+    if(parser.isSet(jobsoption) && (parser.value(jobsoption).toInt() > 0))
+        QThreadPool::globalInstance()->setMaxThreadCount(parser.value(jobsoption).toInt());
+
+    QFile output;
+    output.open(stdout, QFile::WriteOnly | QFile::Unbuffered); /* Lines are streamed as soon as a file is done */
+
+    TemplateRunner templaterunner(parser.value(templateoption), &output);
+    return templaterunner.run(files) ? 1 : 0;
+}
 
 int main(int argc, char *argv[])
 {
+    if(isHeadless(argc, argv))
+        return runHeadless(argc, argv);
+
     QApplication a(argc, argv);
     a.setApplicationDisplayName(QString("PREF 3.0-") + GIT_VERSION);
 
@@ -1,4 +1,5 @@
 #include "basicmodel.h"
+#include "../platform/datadecoder.h"
 #include <QFontDatabase>
 
 QFont BasicModel::_monospacefont;
@@ -20,13 +21,13 @@ QVariant BasicModel::defaultData(int role) const
 QColor BasicModel::highlight(const VMValuePtr &vmvalue) const
 {
     if(vmvalue->is_integer())
-        return QColor(Qt::darkBlue);
+        return DataDecoder::categoryColor(DataDecoder::Integer);
     else if(vmvalue->is_floating_point())
-        return QColor(Qt::darkRed);
+        return DataDecoder::categoryColor(DataDecoder::FloatingPoint);
     else if(vmvalue->is_string())
-        return QColor(Qt::darkGreen);
+        return DataDecoder::categoryColor(DataDecoder::Text);
 
-    return QColor(Qt::black);
+    return DataDecoder::categoryColor(DataDecoder::Other);
 }
 
 BasicListModel::BasicListModel(QObject *parent): QAbstractListModel(parent), BasicModel()
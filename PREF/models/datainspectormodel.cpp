@@ -1,11 +1,12 @@
 #include "datainspectormodel.h"
-#include "../platform/loadeddata.h"
-#include "../platform/btvmex.h"
-#include <support/datainspector.h>
 
 DataInspectorModel::DataInspectorModel(QHexEdit *hexedit, QObject *parent) : BasicListModel(parent), _hexedit(hexedit)
 {
+    for(int i = 0; i < DataDecoder::TypeCount; i++)
+        this->_values.append(QString());
+
     connect(this->_hexedit->document()->cursor(), &QHexCursor::positionChanged, this, &DataInspectorModel::inspect);
+    connect(this->_hexedit->document(), &QHexDocument::documentChanged, this, &DataInspectorModel::inspect);
     this->inspect();
 }
 
@@ -29,48 +30,46 @@ QVariant DataInspectorModel::headerData(int section, Qt::Orientation orientation
 
 QVariant DataInspectorModel::data(const QModelIndex &index, int role) const
 {
-    if(!this->_data)
-        return BasicListModel::data(index, role);
-
-    const VMValuePtr& vmvalue = this->_data->m_value[index.row()];
-
     if(role == Qt::DisplayRole)
     {
         if(index.column() == 0)
-            return s_qs(vmvalue->value_typeid);
+            return DataDecoder::typeName(index.row());
         else if(index.column() == 1)
-            return s_qs(vmvalue->printable(16));
+            return this->_values[index.row()];
     }
     else if((role == Qt::ForegroundRole) && (index.column() == 1))
-        return this->highlight(vmvalue);
+        return DataDecoder::categoryColor(DataDecoder::category(index.row()));
 
     return BasicListModel::data(index, role);
 }
 
 int DataInspectorModel::rowCount(const QModelIndex &) const
 {
-    if(!this->_data)
-        return 0;
-
-    return this->_data->m_value.size();
+    return DataDecoder::TypeCount;
 }
 
 void DataInspectorModel::inspect()
 {
     QHexDocument* document = this->_hexedit->document();
-    LoadedData loadeddata(document);
-    loadeddata.seek(document->cursor()->offset());
+    QByteArray window = document->read(document->cursor()->offset(), DataDecoder::WINDOW_SIZE);
+    const uchar* data = reinterpret_cast<const uchar*>(window.constData());
+    int first = -1, last = -1;
 
-    this->beginResetModel();
+    for(int i = 0; i < DataDecoder::TypeCount; i++)
+    {
+        QString value = DataDecoder::decode(i, data, window.size());
+
+        if(value == this->_values[i])
+            continue;
 
-    BTVMEX btvm(this->_hexedit->document(), &loadeddata);
-    btvm.evaluate(DATA_INSPECTOR_CODE);
-    BTEntryList btentries = btvm.createTemplate();
+        this->_values[i] = value;
 
-    if(!btentries.empty())
-        this->_data = btentries.front()->value;
-    else
-        this->_data = NULL;
+        if(first == -1)
+            first = i;
+
+        last = i;
+    }
 
-    this->endResetModel();
+    if(first != -1) /* Rows are fixed: only repaint the values that changed */
+        emit dataChanged(this->index(first, 1), this->index(last, 1));
 }
@@ -1,7 +1,9 @@
 #ifndef DATAINSPECTORMODEL_H
 #define DATAINSPECTORMODEL_H
 
+#include <QStringList>
 #include <qhexedit/qhexedit.h>
+#include "../platform/datadecoder.h"
 #include "basicmodel.h"
 
 class DataInspectorModel : public BasicListModel
@@ -19,7 +21,7 @@ class DataInspectorModel : public BasicListModel
         void inspect();
 
     private:
-        VMValuePtr _data;
+        QStringList _values;
         QHexEdit* _hexedit;
 };
 
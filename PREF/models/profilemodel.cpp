@@ -0,0 +1,104 @@
+#include "profilemodel.h"
+#include <algorithm>
+
+ProfileModel::ProfileModel(QObject *parent) : BasicListModel(parent), _sortcolumn(2), _sortorder(Qt::DescendingOrder)
+{
+
+}
+
+void ProfileModel::setRecords(const TemplateProfiler::RecordList &records)
+{
+    this->beginResetModel();
+    this->_records = records;
+    this->endResetModel();
+
+    this->sort(this->_sortcolumn, this->_sortorder);
+}
+
+int ProfileModel::columnCount(const QModelIndex &) const
+{
+    return 5;
+}
+
+QVariant ProfileModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if((orientation != Qt::Horizontal) || (role != Qt::DisplayRole))
+        return QVariant();
+
+    if(section == 0)
+        return tr("Type");
+    else if(section == 1)
+        return tr("Count");
+    else if(section == 2)
+        return tr("Time (ms)");
+    else if(section == 3)
+        return tr("Time per entry (us)");
+    else if(section == 4)
+        return tr("Bytes");
+
+    return QVariant();
+}
+
+QVariant ProfileModel::data(const QModelIndex &index, int role) const
+{
+    const TemplateProfiler::Record& r = this->_records[index.row()];
+
+    if(role == Qt::DisplayRole)
+    {
+        if(index.column() == 0)
+            return r.TypeName;
+        else if(index.column() == 1)
+            return r.Count;
+        else if(index.column() == 2)
+            return QString::number(r.Time / 1000000.0, 'f', 3);
+        else if(index.column() == 3)
+            return r.Count ? QString::number((r.Time / 1000.0) / r.Count, 'f', 3) : QString();
+        else if(index.column() == 4)
+            return QString::number(r.Bytes, 16).toUpper() + "h";
+    }
+    else if(role == Qt::TextAlignmentRole)
+    {
+        if(index.column() > 0)
+            return static_cast<int>(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    else if(role == Qt::ForegroundRole)
+    {
+        if(index.column() == 0)
+            return QColor(Qt::darkGreen);
+
+        return QColor(Qt::darkBlue);
+    }
+
+    return BasicListModel::data(index, role);
+}
+
+int ProfileModel::rowCount(const QModelIndex &) const
+{
+    return this->_records.size();
+}
+
+void ProfileModel::sort(int column, Qt::SortOrder order)
+{
+    this->_sortcolumn = column;
+    this->_sortorder = order;
+
+    emit layoutAboutToBeChanged();
+
+    std::stable_sort(this->_records.begin(), this->_records.end(), [column](const TemplateProfiler::Record& r1, const TemplateProfiler::Record& r2) {
+        if(column == 0)
+            return r1.TypeName < r2.TypeName;
+        else if(column == 1)
+            return r1.Count < r2.Count;
+        else if(column == 3)
+            return (r1.Time * qMax(r2.Count, 1)) < (r2.Time * qMax(r1.Count, 1));
+        else if(column == 4)
+            return r1.Bytes < r2.Bytes;
+
+        return r1.Time < r2.Time;
+    });
+
+    if(order == Qt::DescendingOrder)
+        std::reverse(this->_records.begin(), this->_records.end());
+
+    emit layoutChanged();
+}
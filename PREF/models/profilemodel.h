@@ -0,0 +1,26 @@
+#ifndef PROFILEMODEL_H
+#define PROFILEMODEL_H
+
+#include "../platform/templateprofiler.h"
+#include "basicmodel.h"
+
+class ProfileModel : public BasicListModel
+{
+    Q_OBJECT
+
+    public:
+        explicit ProfileModel(QObject *parent = 0);
+        void setRecords(const TemplateProfiler::RecordList& records);
+        virtual int columnCount(const QModelIndex &) const;
+        virtual QVariant headerData(int section, Qt::Orientation orientation, int role) const;
+        virtual QVariant data(const QModelIndex &index, int role) const;
+        virtual int rowCount(const QModelIndex &) const;
+        virtual void sort(int column, Qt::SortOrder order);
+
+    private:
+        TemplateProfiler::RecordList _records;
+        int _sortcolumn;
+        Qt::SortOrder _sortorder;
+};
+
+#endif // PROFILEMODEL_H
@@ -1,21 +1,91 @@
 #include "stringsmodel.h"
 #include <QColor>
+#include <algorithm>
 
-StringsModel::StringsModel(QHexDocument *document, QObject *parent) : BasicListModel(parent), _document(document)
+const int StringsModel::CACHE_SIZE = 0x100000; /* Characters */
+
+StringsModel::StringsModel(QObject *parent) : BasicListModel(parent), _cache(StringsModel::CACHE_SIZE), _filtered(false), _rowcount(0)
+{
+
+}
+
+void StringsModel::appendStrings(StringArena &&strings)
 {
+    if(strings.isEmpty())
+        return;
+
+    if(this->_filtered) /* Rows show up when the filter accepts them */
+    {
+        this->_batchrows.append(this->_rowcount);
+        this->_rowcount += strings.size();
+        this->_batches.append(std::move(strings));
+        return;
+    }
 
+    this->beginInsertRows(QModelIndex(), this->_rowcount, this->_rowcount + strings.size() - 1);
+    this->_batchrows.append(this->_rowcount);
+    this->_rowcount += strings.size();
+    this->_batches.append(std::move(strings));
+    this->endInsertRows();
 }
 
-void StringsModel::initialize(const ByteElaborator::StringList &stringlist)
+void StringsModel::clear()
 {
     this->beginResetModel();
-    this->_stringlist = stringlist;
+    this->_batches.clear();
+    this->_batchrows.clear();
+    this->_filteredrows.clear();
+    this->_cache.clear();
+    this->_rowcount = 0;
     this->endResetModel();
 }
 
+void StringsModel::setFiltered(bool b)
+{
+    this->beginResetModel();
+    this->_filtered = b;
+    this->_filteredrows.clear();
+    this->endResetModel();
+}
+
+void StringsModel::appendFilteredRows(const QVector<int> &rows)
+{
+    if(!this->_filtered || rows.isEmpty())
+        return;
+
+    this->beginInsertRows(QModelIndex(), this->_filteredrows.size(), this->_filteredrows.size() + rows.size() - 1);
+    this->_filteredrows += rows;
+    this->endInsertRows();
+}
+
+bool StringsModel::isFiltered() const
+{
+    return this->_filtered;
+}
+
+const QVector<StringArena> &StringsModel::batches() const
+{
+    return this->_batches;
+}
+
+int StringsModel::batchRow(int batch) const
+{
+    if(batch >= this->_batchrows.size())
+        return this->_rowcount;
+
+    return this->_batchrows[batch];
+}
+
+const StringScanner::Match &StringsModel::match(int row) const
+{
+    int index = 0;
+    int batch = this->locate(this->sourceRow(row), &index);
+    return this->_batches[batch].match(index);
+}
+
 int StringsModel::columnCount(const QModelIndex &) const
 {
-    return 2;
+    return 3;
 }
 
 QVariant StringsModel::headerData(int section, Qt::Orientation orientation, int role) const
@@ -26,6 +96,8 @@ QVariant StringsModel::headerData(int section, Qt::Orientation orientation, int
     if(section == 0)
         return tr("Offset");
     else if(section == 1)
+        return tr("Encoding");
+    else if(section == 2)
         return tr("String");
 
     return QVariant();
@@ -35,18 +107,22 @@ QVariant StringsModel::data(const QModelIndex &index, int role) const
 {
     if(role == Qt::DisplayRole)
     {
-        const ByteElaborator::StringRange& sr = this->_stringlist[index.row()];
+        const StringScanner::Match& m = this->match(index.row());
 
         if(index.column() == 0)
-            return QString::number(sr.Start, 16).toUpper() + "h";
+            return QString::number(m.Start, 16).toUpper() + "h";
         else if(index.column() == 1)
-            return this->string(sr);
+            return StringsModel::encodingName(m.Encoding);
+        else if(index.column() == 2)
+            return this->string(this->sourceRow(index.row()));
     }
     else if(role == Qt::ForegroundRole)
     {
         if(index.column() == 0)
             return QColor(Qt::darkBlue);
         else if(index.column() == 1)
+            return QColor(Qt::darkGray);
+        else if(index.column() == 2)
             return QColor(Qt::darkGreen);
     }
 
@@ -55,10 +131,48 @@ QVariant StringsModel::data(const QModelIndex &index, int role) const
 
 int StringsModel::rowCount(const QModelIndex &) const
 {
-    return this->_stringlist.size();
+    if(this->_filtered)
+        return this->_filteredrows.size();
+
+    return this->_rowcount;
+}
+
+QString StringsModel::string(int row) const
+{
+    QString* s = this->_cache.object(row);
+
+    if(s)
+        return *s;
+
+    int index = 0;
+    int batch = this->locate(row, &index);
+    QString str = this->_batches[batch].string(index);
+
+    this->_cache.insert(row, new QString(str), str.length() + 1);
+    return str;
+}
+
+int StringsModel::locate(int row, int *index) const
+{
+    int batch = static_cast<int>(std::upper_bound(this->_batchrows.begin(), this->_batchrows.end(), row) - this->_batchrows.begin()) - 1;
+    *index = row - this->_batchrows[batch];
+    return batch;
 }
 
-QString StringsModel::string(const ByteElaborator::StringRange &sr) const
+int StringsModel::sourceRow(int row) const
 {
-    return this->_document->read(sr.Start, sr.End - sr.Start);
+    if(this->_filtered)
+        return this->_filteredrows[row];
+
+    return row;
+}
+
+QString StringsModel::encodingName(int encoding)
+{
+    if(encoding == StringScanner::Utf8)
+        return "UTF-8";
+    else if(encoding == StringScanner::Utf16LE)
+        return "UTF-16LE";
+
+    return "ASCII";
 }
@@ -1,30 +1,43 @@
 #ifndef STRINGSMODEL_H
 #define STRINGSMODEL_H
 
-#include <qhexedit/document/qhexdocument.h>
-#include <support/byteelaborator.h>
+#include <QCache>
+#include "../platform/analysis/stringarena.h"
 #include "basicmodel.h"
 
-using namespace PrefLib::Support;
-
 class StringsModel : public BasicListModel
 {
     Q_OBJECT
 
     public:
-        explicit StringsModel(QHexDocument* document, QObject *parent = 0);
-        void initialize(const ByteElaborator::StringList& stringlist);
+        explicit StringsModel(QObject *parent = 0);
+        void appendStrings(StringArena&& strings);
+        void clear();
+        void setFiltered(bool b);
+        void appendFilteredRows(const QVector<int>& rows);
+        bool isFiltered() const;
+        const QVector<StringArena>& batches() const;
+        int batchRow(int batch) const;
+        const StringScanner::Match& match(int row) const;
         virtual int columnCount(const QModelIndex &) const;
         virtual QVariant headerData(int section, Qt::Orientation orientation, int role) const;
         virtual QVariant data(const QModelIndex &index, int role) const;
         virtual int rowCount(const QModelIndex &) const;
 
     private:
-        QString string(const ByteElaborator::StringRange& sr) const;
+        QString string(int row) const;
+        int locate(int row, int* index) const;
+        int sourceRow(int row) const;
+        static QString encodingName(int encoding);
 
     private:
-        ByteElaborator::StringList _stringlist;
-        QHexDocument* _document;
+        static const int CACHE_SIZE;
+        QVector<StringArena> _batches;       /* Owned as received from the scanner, never copied */
+        QVector<int> _batchrows;             /* First row of each batch */
+        mutable QCache<int, QString> _cache; /* Row -> Decoded string */
+        QVector<int> _filteredrows;          /* Visible rows while filtered */
+        bool _filtered;
+        int _rowcount;
 };
 
 #endif // STRINGSMODEL_H
@@ -1,36 +1,162 @@
 #include "templatemodel.h"
-#include "../platform/btvmex.h"
 #include "../widgets/logwidget/logwidget.h"
+#include "../platform/datadecoder.h"
 #include <QIcon>
 
-TemplateModel::TemplateModel(QHexEdit *hexedit, QObject *parent) : BasicItemModel(parent), _hexedit(hexedit)
+const int TemplateModel::VALUE_CACHE_SIZE = 0x100000; /* Characters */
+
+TemplateModel::TemplateModel(QHexEdit *hexedit, QObject *parent) : BasicItemModel(parent), _hexedit(hexedit), _templateworker(NULL), _valuecache(TemplateModel::VALUE_CACHE_SIZE), _generation(0), _executinggeneration(0), _executingprofiled(false), _profiling(false)
 {
-    this->_loadeddata = new LoadedData(hexedit->document());
+    /* Cached results describe the data they were built from */
+    connect(hexedit->document(), &QHexDocument::documentChanged, this, [this]() {
+        this->_generation++;
+        this->_cache.clear();
+        this->_arrayview.clear();
+        this->_valuecache.clear();
+    });
 }
 
 TemplateModel::~TemplateModel()
 {
-    delete this->_loadeddata;
-    this->_loadeddata = NULL;
+    this->abort();
+
+    foreach(TemplateWorker* templateworker, this->findChildren<TemplateWorker*>()) /* Aborted executions may still be unwinding */
+        templateworker->wait();
 }
 
-void TemplateModel::execute(const QString &btfile, LogWidget* logwidget)
+void TemplateModel::execute(const QString &btfile, LogWidget* logwidget, const QString &exportfile)
 {
-    this->beginResetModel();
+    this->abort();
+
+    TemplateCache::Key key = TemplateCache::key(btfile);
+    TemplateResultPtr result;
+
+    if(exportfile.isEmpty() && !this->_profiling) /* Exports and profiles come from the VM itself */
+        result = this->_cache.find(key);
+
+    if(result) /* Same template on unchanged data: nothing to run */
+    {
+        foreach(const QString& s, result->Output)
+            logwidget->log(s);
+
+        this->showResult(result);
+        return;
+    }
+
+    this->_executingkey = key;
+    this->_executinggeneration = this->_generation;
+    this->_executingprofiled = this->_profiling;
+    this->_templateworker = new TemplateWorker(this->_hexedit->document(), btfile, exportfile, this->_profiling, this);
+    connect(this->_templateworker, &TemplateWorker::printed, logwidget, &LogWidget::log);
+    connect(this->_templateworker, &TemplateWorker::progressChanged, this, &TemplateModel::progressChanged);
+    connect(this->_templateworker, &TemplateWorker::finished, this, &TemplateModel::completeExecution);
+    connect(this->_templateworker, &TemplateWorker::finished, this->_templateworker, &TemplateWorker::deleteLater);
+
+    emit executionStarted();
+    this->_templateworker->start();
+}
+
+void TemplateModel::setProfiling(bool b)
+{
+    this->_profiling = b;
+}
+
+bool TemplateModel::isProfiling() const
+{
+    return this->_profiling;
+}
+
+TemplateProfiler::RecordList TemplateModel::profile() const
+{
+    if(!this->_result)
+        return TemplateProfiler::RecordList();
+
+    return this->_result->Profile;
+}
+
+void TemplateModel::abort()
+{
+    if(!this->_templateworker)
+        return;
 
-    BTVMEX btvm(this->_hexedit->document(), logwidget, this->_loadeddata);
-    btvm.execute(qs_s(btfile));
-    this->_template = btvm.createTemplate();
+    disconnect(this->_templateworker, NULL, this, NULL); /* The current template stays in place */
+    this->_templateworker->abort();
+    this->_templateworker = NULL;
+    emit executionFinished();
+}
+
+bool TemplateModel::isExecuting() const
+{
+    return this->_templateworker != NULL;
+}
 
+void TemplateModel::showResult(const TemplateResultPtr &result)
+{
+    this->beginResetModel();
+    this->_arrayview.clear();
+    this->_valuecache.clear();
+    this->_result = result;
     this->endResetModel();
+
+    this->_hexedit->document()->clearMetadata();
+    result->Highlights.apply(this->_hexedit->document());
+    emit resultChanged();
+}
+
+void TemplateModel::completeExecution()
+{
+    TemplateWorker* templateworker = this->_templateworker;
+    this->_templateworker = NULL;
+
+    if(!templateworker || templateworker->isAborted())
+    {
+        emit executionFinished();
+        return;
+    }
+
+    TemplateResultPtr result = templateworker->takeResult();
+
+    /* An edit during execution leaves the result stale, a profile is only meaningful for its own run: show them, never reuse them */
+    if((this->_executinggeneration == this->_generation) && !this->_executingprofiled)
+        this->_cache.insert(this->_executingkey, result);
+
+    this->showResult(result);
+    emit executionFinished();
+}
+
+bool TemplateModel::range(const QModelIndex &index, integer_t *offset, integer_t *size) const
+{
+    if(!index.isValid())
+        return false;
+
+    if(TemplateModel::isElement(index))
+    {
+        TemplateResult::LazyArray* lazyarray = TemplateModel::lazyArray(index);
+        *offset = lazyarray->Base + (index.row() * lazyarray->Stride);
+        *size = lazyarray->Stride;
+        return true;
+    }
+
+    BTEntry* btentry = reinterpret_cast<BTEntry*>(index.internalPointer());
+    *offset = btentry->location.offset;
+    *size = btentry->location.size;
+    return true;
 }
 
 QModelIndex TemplateModel::index(int row, int column, const QModelIndex &parent) const
 {
     if(!parent.isValid())
-        return this->createIndex(row, column, this->_template[row].get());
+        return this->createIndex(row, column, this->_result->Template[row].get());
+
+    if(TemplateModel::isElement(parent))
+        return QModelIndex();
 
     BTEntry* parententry = reinterpret_cast<BTEntry*>(parent.internalPointer());
+    TemplateResult::LazyArray* lazyarray = this->_result->Arrays.value(parententry);
+
+    if(lazyarray) /* Elements point to their array descriptor, tagged in the lowest bit */
+        return this->createIndex(row, column, reinterpret_cast<quintptr>(lazyarray) | 1);
+
     return this->createIndex(row, column, parententry->children[row].get());
 }
 
@@ -39,17 +165,15 @@ QModelIndex TemplateModel::parent(const QModelIndex &child) const
     if(!child.isValid())
         return QModelIndex();
 
+    if(TemplateModel::isElement(child))
+        return this->entryIndex(TemplateModel::lazyArray(child)->Entry, 0);
+
     BTEntry* childentry = reinterpret_cast<BTEntry*>(child.internalPointer());
 
     if(!childentry->parent)
         return QModelIndex();
 
-    int idx = this->childIndex(childentry, childentry->parent->children);
-
-    if(idx == -1)
-        return QModelIndex();
-
-    return this->createIndex(idx, 0, childentry->parent.get());
+    return this->entryIndex(childentry->parent.get(), 0);
 }
 
 QVariant TemplateModel::headerData(int section, Qt::Orientation orientation, int role) const
@@ -76,6 +200,9 @@ QVariant TemplateModel::data(const QModelIndex &index, int role) const
     if(!index.isValid())
         return BasicItemModel::data(index, role);
 
+    if(TemplateModel::isElement(index))
+        return this->elementData(index, role);
+
     BTEntry* btentry = reinterpret_cast<BTEntry*>(index.internalPointer());
 
     if(role == Qt::DisplayRole)
@@ -83,7 +210,10 @@ QVariant TemplateModel::data(const QModelIndex &index, int role) const
         if(index.column() == 0)
             return s_qs(btentry->name);
         else if(index.column() == 1)
-            return s_qs(btentry->value->printable(16));
+        {
+            TemplateResult::LazyArray* lazyarray = this->_result->Arrays.value(btentry);
+            return lazyarray ? lazyarray->Value : this->entryValue(btentry);
+        }
         else if(index.column() == 2)
             return QString::number(btentry->location.offset, 16).toUpper() + "h";
         else if(index.column() == 3)
@@ -120,20 +250,83 @@ int TemplateModel::columnCount(const QModelIndex &) const
 
 int TemplateModel::rowCount(const QModelIndex &parent) const
 {
+    if(!this->_result)
+        return 0;
+
     if(!parent.isValid())
-        return this->_template.size();
+        return this->_result->Template.size();
+
+    if(TemplateModel::isElement(parent))
+        return 0;
 
     BTEntry* parententry = reinterpret_cast<BTEntry*>(parent.internalPointer());
+    TemplateResult::LazyArray* lazyarray = this->_result->Arrays.value(parententry);
+
+    if(lazyarray)
+        return lazyarray->Count;
+
     return parententry->children.size();
 }
 
-int TemplateModel::childIndex(BTEntry *btentry, const BTEntryList &entries) const
+QModelIndex TemplateModel::entryIndex(BTEntry *btentry, int column) const
+{
+    auto it = this->_result->Rows.constFind(btentry);
+
+    if(it == this->_result->Rows.constEnd())
+        return QModelIndex();
+
+    return this->createIndex(it.value(), column, btentry);
+}
+
+QVariant TemplateModel::elementData(const QModelIndex &index, int role) const
 {
-    for(auto it = entries.begin(); it != entries.end(); it++)
+    TemplateResult::LazyArray* lazyarray = TemplateModel::lazyArray(index);
+    integer_t offset = lazyarray->Base + (index.row() * lazyarray->Stride);
+
+    if(role == Qt::DisplayRole)
     {
-        if(btentry == (*it).get())
-            return std::distance(entries.begin(), it);
+        if(index.column() == 0)
+            return QString("%1[%2]").arg(s_qs(lazyarray->Entry->name)).arg(index.row());
+        else if(index.column() == 1) /* Decoded on demand from the page around the row */
+            return this->_arrayview.value(lazyarray, index.row(), this->_hexedit->document());
+        else if(index.column() == 2)
+            return QString::number(offset, 16).toUpper() + "h";
+        else if(index.column() == 3)
+            return QString::number(lazyarray->Stride, 16).toUpper() + "h";
+    }
+    else if((role == Qt::DecorationRole) && (index.column() == 0))
+        return QIcon(":/res/field.png");
+    else if(role == Qt::ForegroundRole)
+    {
+        if(index.column() == 1)
+            return DataDecoder::categoryColor(DataDecoder::category(lazyarray->Type));
+        else if((index.column() == 2) || (index.column() == 3))
+            return QColor(Qt::darkBlue);
     }
+    else if((role == Qt::FontRole) && (index.column() == 0))
+        return QVariant();
 
-    return -1;
+    return BasicItemModel::data(index, role);
+}
+
+QString TemplateModel::entryValue(const BTEntry *btentry) const
+{
+    QString* s = this->_valuecache.object(btentry);
+
+    if(s) /* Views ask again on every repaint and resize */
+        return *s;
+
+    QString value = s_qs(btentry->value->printable(16));
+    this->_valuecache.insert(btentry, new QString(value), value.length() + 1);
+    return value;
+}
+
+bool TemplateModel::isElement(const QModelIndex &index)
+{
+    return index.internalId() & 1;
+}
+
+TemplateResult::LazyArray *TemplateModel::lazyArray(const QModelIndex &index)
+{
+    return reinterpret_cast<TemplateResult::LazyArray*>(index.internalId() & ~static_cast<quintptr>(1));
 }
@@ -2,9 +2,12 @@
 #define TEMPLATEMODEL_H
 
 #include <qhexedit/qhexedit.h>
-#include "../platform/loadeddata.h"
+#include "../platform/templateworker.h"
+#include "../platform/templatecache.h"
+#include "../platform/arrayview.h"
 #include "../widgets/logwidget/logwidget.h"
 #include "basicmodel.h"
+#include <QCache>
 
 class TemplateModel : public BasicItemModel
 {
@@ -15,7 +18,13 @@ class TemplateModel : public BasicItemModel
         ~TemplateModel();
 
     public:
-        void execute(const QString& btfile, LogWidget *logwidget);
+        void execute(const QString& btfile, LogWidget *logwidget, const QString& exportfile = QString());
+        void setProfiling(bool b);
+        bool isProfiling() const;
+        TemplateProfiler::RecordList profile() const;
+        void abort();
+        bool isExecuting() const;
+        bool range(const QModelIndex& index, integer_t* offset, integer_t* size) const;
         virtual QModelIndex index(int row, int column, const QModelIndex &parent) const;
         virtual QModelIndex parent(const QModelIndex &child) const;
         virtual QVariant headerData(int section, Qt::Orientation orientation, int role) const;
@@ -24,12 +33,36 @@ class TemplateModel : public BasicItemModel
         virtual int rowCount(const QModelIndex &parent) const;
 
     private:
-        int childIndex(BTEntry* btentry, const BTEntryList& entries) const;
+        QModelIndex entryIndex(BTEntry* btentry, int column) const;
+        QVariant elementData(const QModelIndex &index, int role) const;
+        QString entryValue(const BTEntry* btentry) const;
+        static bool isElement(const QModelIndex& index);
+        static TemplateResult::LazyArray* lazyArray(const QModelIndex& index);
+
+        void showResult(const TemplateResultPtr& result);
+
+    private slots:
+        void completeExecution();
+
+    signals:
+        void executionStarted();
+        void progressChanged(integer_t covered, int entries);
+        void executionFinished();
+        void resultChanged();
 
     private:
+        static const int VALUE_CACHE_SIZE;
         QHexEdit* _hexedit;
-        LoadedData* _loadeddata;
-        BTEntryList _template;
+        TemplateWorker* _templateworker;
+        TemplateResultPtr _result;
+        mutable ArrayView _arrayview;
+        mutable QCache<const BTEntry*, QString> _valuecache; /* Entry -> Formatted value */
+        TemplateCache _cache;
+        TemplateCache::Key _executingkey;
+        uint _generation;          /* Bumped on every edit */
+        uint _executinggeneration; /* _generation when the execution started */
+        bool _executingprofiled;
+        bool _profiling;
 };
 
 #endif // TEMPLATEMODEL_H
@@ -0,0 +1,68 @@
+#include "analysisconsumer.h"
+
+AnalysisConsumer::AnalysisConsumer(QObject *parent) : QObject(parent), _progress(-1)
+{
+
+}
+
+void AnalysisConsumer::reportProgress(integer_t processed, integer_t total)
+{
+    int progress = total ? static_cast<int>((processed * 100) / total) : 100;
+
+    if(progress == this->_progress)
+        return;
+
+    this->_progress = progress;
+    emit progressChanged(progress);
+}
+
+void AnalysisConsumer::complete()
+{
+    this->end();
+    emit completed();
+}
+
+bool AnalysisConsumer::isParallel() const
+{
+    return false;
+}
+
+void AnalysisConsumer::begin(integer_t)
+{
+    this->_progress = -1;
+}
+
+void AnalysisConsumer::prepareChunks(int)
+{
+
+}
+
+void AnalysisConsumer::consumeChunk(int, integer_t, const uchar*, integer_t)
+{
+
+}
+
+void AnalysisConsumer::finishChunk(int, integer_t, const uchar*, integer_t)
+{
+
+}
+
+void AnalysisConsumer::consume(integer_t, const uchar*, integer_t)
+{
+
+}
+
+void AnalysisConsumer::completeChunks(int)
+{
+
+}
+
+void AnalysisConsumer::end()
+{
+
+}
+
+bool AnalysisConsumer::update(integer_t, const QByteArray&, const QByteArray&)
+{
+    return false; /* Full pass needed */
+}
@@ -0,0 +1,35 @@
+#ifndef ANALYSISCONSUMER_H
+#define ANALYSISCONSUMER_H
+
+#include <QObject>
+#include <qhexedit/document/qhexdocument.h>
+
+class AnalysisConsumer : public QObject
+{
+    Q_OBJECT
+
+    public:
+        explicit AnalysisConsumer(QObject *parent = 0);
+        void reportProgress(integer_t processed, integer_t total);
+        void complete();
+
+    public:
+        virtual bool isParallel() const;
+        virtual void begin(integer_t size);
+        virtual void prepareChunks(int count);
+        virtual void consumeChunk(int chunk, integer_t offset, const uchar* data, integer_t length);
+        virtual void finishChunk(int chunk, integer_t offset, const uchar* data, integer_t length);
+        virtual void consume(integer_t offset, const uchar* data, integer_t length);
+        virtual void completeChunks(int count);
+        virtual void end();
+        virtual bool update(integer_t offset, const QByteArray& before, const QByteArray& after);
+
+    signals:
+        void progressChanged(int percent);
+        void completed();
+
+    private:
+        int _progress;
+};
+
+#endif // ANALYSISCONSUMER_H
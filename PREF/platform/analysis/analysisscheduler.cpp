@@ -0,0 +1,78 @@
+#include "analysisscheduler.h"
+
+const int AnalysisScheduler::RECALCULATE_DELAY = 500;
+
+AnalysisScheduler::AnalysisScheduler(QHexDocument *document, QObject *parent) : QObject(parent), _document(document), _analysisworker(NULL)
+{
+    this->_recalculatetimer = new QTimer(this);
+    this->_recalculatetimer->setSingleShot(true);
+    this->_recalculatetimer->setInterval(AnalysisScheduler::RECALCULATE_DELAY);
+
+    connect(this->_recalculatetimer, &QTimer::timeout, this, &AnalysisScheduler::runPending);
+}
+
+AnalysisScheduler::~AnalysisScheduler()
+{
+    this->abort();
+}
+
+bool AnalysisScheduler::isScheduled(AnalysisConsumer *consumer) const
+{
+    return this->_pending.contains(consumer) || this->_running.contains(consumer);
+}
+
+void AnalysisScheduler::schedule(AnalysisConsumer *consumer)
+{
+    if(!this->_pending.contains(consumer))
+        this->_pending.append(consumer);
+
+    if(!this->_analysisworker) /* Coalesce bursts of edits into a single pass, a running one is followed by the next */
+        this->_recalculatetimer->start();
+}
+
+void AnalysisScheduler::start()
+{
+    this->_recalculatetimer->stop();
+    this->runPending();
+}
+
+void AnalysisScheduler::abort()
+{
+    this->_recalculatetimer->stop();
+    this->_pending.clear();
+
+    if(!this->_analysisworker)
+        return;
+
+    disconnect(this->_analysisworker, NULL, this, NULL);
+    this->_analysisworker->abort();
+    this->_analysisworker->wait(); /* Consumers may be destroyed right after */
+    this->_analysisworker = NULL;
+    this->_running.clear();
+}
+
+void AnalysisScheduler::runPending()
+{
+    if(this->_analysisworker || this->_pending.isEmpty())
+        return;
+
+    this->_analysisworker = new AnalysisWorker(this->_document, this);
+    connect(this->_analysisworker, &AnalysisWorker::finished, this, &AnalysisScheduler::passFinished);
+    connect(this->_analysisworker, &AnalysisWorker::finished, this->_analysisworker, &AnalysisWorker::deleteLater);
+
+    foreach(AnalysisConsumer* consumer, this->_pending) /* One pass over the file feeds every consumer that asked for it */
+        this->_analysisworker->addConsumer(consumer);
+
+    this->_running = this->_pending;
+    this->_pending.clear();
+    this->_analysisworker->start();
+}
+
+void AnalysisScheduler::passFinished()
+{
+    this->_analysisworker = NULL;
+    this->_running.clear();
+
+    if(!this->_pending.isEmpty()) /* Edits arrived while the pass was running */
+        this->_recalculatetimer->start();
+}
@@ -0,0 +1,34 @@
+#ifndef ANALYSISSCHEDULER_H
+#define ANALYSISSCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QList>
+#include "analysisworker.h"
+
+class AnalysisScheduler : public QObject /* Owns the one AnalysisWorker of a document: every full pass goes through here */
+{
+    Q_OBJECT
+
+    public:
+        explicit AnalysisScheduler(QHexDocument* document, QObject *parent = 0);
+        ~AnalysisScheduler();
+        bool isScheduled(AnalysisConsumer* consumer) const;
+        void schedule(AnalysisConsumer* consumer);
+        void start();
+        void abort();
+
+    private slots:
+        void runPending();
+        void passFinished();
+
+    private:
+        static const int RECALCULATE_DELAY;
+        QHexDocument* _document;
+        AnalysisWorker* _analysisworker;
+        QList<AnalysisConsumer*> _pending; /* Waiting for the next pass */
+        QList<AnalysisConsumer*> _running; /* Fed by the current pass */
+        QTimer* _recalculatetimer;
+};
+
+#endif // ANALYSISSCHEDULER_H
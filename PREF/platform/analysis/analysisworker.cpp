@@ -0,0 +1,161 @@
+#include "analysisworker.h"
+#include <QtConcurrent>
+
+const integer_t AnalysisWorker::CHUNK_SIZE = 0x400000;
+const integer_t AnalysisWorker::BLOCK_SIZE = 0x40000;
+
+AnalysisWorker::AnalysisWorker(QHexDocument *document, QObject *parent) : BasicWorker(document, parent), _parallel(QThread::idealThreadCount() > 1)
+{
+
+}
+
+void AnalysisWorker::addConsumer(AnalysisConsumer *consumer)
+{
+    this->_consumers.append(consumer);
+
+    if(consumer->isParallel())
+        this->_parallelconsumers.append(consumer);
+    else
+        this->_serialconsumers.append(consumer);
+}
+
+void AnalysisWorker::setParallel(bool b)
+{
+    this->_parallel = b;
+}
+
+bool AnalysisWorker::isParallel() const
+{
+    return this->_parallel;
+}
+
+void AnalysisWorker::run()
+{
+    if(!this->_document || this->_consumers.isEmpty())
+        return;
+
+    this->_cancontinue = true;
+
+    MappedFile* mappedfile = MappedFile::fromDocument(this->_document);
+    integer_t size = this->_document->length();
+    int chunkcount = static_cast<int>((size + AnalysisWorker::CHUNK_SIZE - 1) / AnalysisWorker::CHUNK_SIZE);
+    int batchsize = this->_parallel ? qMax(1, QThreadPool::globalInstance()->maxThreadCount()) : 1;
+
+    foreach(AnalysisConsumer* consumer, this->_consumers)
+    {
+        consumer->begin(size);
+        consumer->prepareChunks(chunkcount);
+    }
+
+    for(int i = 0; this->_cancontinue && (i < chunkcount); i += batchsize)
+    {
+        QVector<Chunk> chunks = this->readChunks(mappedfile, i, qMin(batchsize, chunkcount - i), size);
+
+        if(this->_parallel)
+        {
+            /* Order dependent consumers walk the batch while the others split it across the pool */
+            QFuture<void> serialfuture = QtConcurrent::run([this, mappedfile, &chunks]() { this->processSerial(mappedfile, chunks); });
+            QtConcurrent::blockingMap(chunks, [this, mappedfile](const Chunk& chunk) { this->processChunk(mappedfile, chunk); });
+            serialfuture.waitForFinished();
+        }
+        else
+        {
+            foreach(const Chunk& chunk, chunks)
+                this->processChunk(mappedfile, chunk);
+
+            this->processSerial(mappedfile, chunks);
+        }
+
+        integer_t processed = chunks.last().Offset + chunks.last().Length;
+
+        foreach(AnalysisConsumer* consumer, this->_consumers)
+        {
+            consumer->completeChunks(chunks.last().Index + 1);
+            consumer->reportProgress(processed, size);
+        }
+    }
+
+    if(!this->_cancontinue)
+        return;
+
+    foreach(AnalysisConsumer* consumer, this->_consumers)
+        consumer->complete();
+}
+
+QVector<AnalysisWorker::Chunk> AnalysisWorker::readChunks(MappedFile *mappedfile, int first, int count, integer_t size) const
+{
+    QVector<Chunk> chunks(count);
+
+    for(int i = 0; i < count; i++)
+    {
+        Chunk& chunk = chunks[i];
+        chunk.Index = first + i;
+        chunk.Offset = static_cast<integer_t>(chunk.Index) * AnalysisWorker::CHUNK_SIZE;
+        chunk.Length = qMin(AnalysisWorker::CHUNK_SIZE, size - chunk.Offset);
+        chunk.Data = NULL;
+        chunk.Mapped = mappedfile && mappedfile->isMapped();
+
+        if(chunk.Mapped) /* Zero copy: acquired one chunk at a time, edits never wait for a whole batch */
+            continue;
+
+        chunk.Buffer = this->_document->read(chunk.Offset, chunk.Length);
+        chunk.Data = reinterpret_cast<const uchar*>(chunk.Buffer.constData());
+        chunk.Length = chunk.Buffer.size();
+    }
+
+    return chunks;
+}
+
+bool AnalysisWorker::acquireChunk(MappedFile *mappedfile, AnalysisWorker::Chunk &chunk) const
+{
+    if(!chunk.Mapped)
+        return false;
+
+    chunk.Data = mappedfile->acquire(chunk.Offset, chunk.Length);
+
+    if(chunk.Data)
+        return true;
+
+    /* Edited bytes: read a copy from the document */
+    chunk.Buffer = this->_document->read(chunk.Offset, chunk.Length);
+    chunk.Data = reinterpret_cast<const uchar*>(chunk.Buffer.constData());
+    chunk.Length = chunk.Buffer.size();
+    return false;
+}
+
+void AnalysisWorker::processChunk(MappedFile *mappedfile, Chunk chunk) const
+{
+    bool acquired = this->acquireChunk(mappedfile, chunk);
+
+    /* Feed every consumer a cache sized block before moving on */
+    for(integer_t offset = 0; offset < chunk.Length; offset += AnalysisWorker::BLOCK_SIZE)
+    {
+        integer_t len = qMin(AnalysisWorker::BLOCK_SIZE, chunk.Length - offset);
+
+        foreach(AnalysisConsumer* consumer, this->_parallelconsumers)
+            consumer->consumeChunk(chunk.Index, chunk.Offset + offset, chunk.Data + offset, len);
+    }
+
+    foreach(AnalysisConsumer* consumer, this->_parallelconsumers) /* The whole chunk is still readable here */
+        consumer->finishChunk(chunk.Index, chunk.Offset, chunk.Data, chunk.Length);
+
+    if(acquired)
+        mappedfile->release();
+}
+
+void AnalysisWorker::processSerial(MappedFile *mappedfile, const QVector<Chunk> &chunks) const
+{
+    if(this->_serialconsumers.isEmpty())
+        return;
+
+    foreach(Chunk chunk, chunks)
+    {
+        bool acquired = this->acquireChunk(mappedfile, chunk);
+
+        foreach(AnalysisConsumer* consumer, this->_serialconsumers)
+            consumer->consume(chunk.Offset, chunk.Data, chunk.Length);
+
+        if(acquired)
+            mappedfile->release();
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef ANALYSISWORKER_H
+#define ANALYSISWORKER_H
+
+#include <QList>
+#include <QVector>
+#include "../basicworker.h"
+#include "../mappedfile.h"
+#include "analysisconsumer.h"
+
+class AnalysisWorker : public BasicWorker
+{
+    Q_OBJECT
+
+    private:
+        struct Chunk
+        {
+            int Index;
+            integer_t Offset;
+            integer_t Length;
+            const uchar* Data;
+            QByteArray Buffer;
+            bool Mapped;           /* Acquired from the mapping when it's used, Buffer holds a copy otherwise */
+        };
+
+    public:
+        explicit AnalysisWorker(QHexDocument *document, QObject *parent = 0);
+        void addConsumer(AnalysisConsumer* consumer);
+        void setParallel(bool b);
+        bool isParallel() const;
+
+    protected:
+        virtual void run();
+
+    private:
+        QVector<Chunk> readChunks(MappedFile* mappedfile, int first, int count, integer_t size) const;
+        bool acquireChunk(MappedFile* mappedfile, Chunk& chunk) const;
+        void processChunk(MappedFile* mappedfile, Chunk chunk) const;
+        void processSerial(MappedFile* mappedfile, const QVector<Chunk>& chunks) const;
+
+    private:
+        static const integer_t CHUNK_SIZE;
+        static const integer_t BLOCK_SIZE;
+        QList<AnalysisConsumer*> _consumers;
+        QList<AnalysisConsumer*> _parallelconsumers;
+        QList<AnalysisConsumer*> _serialconsumers;
+        bool _parallel;
+};
+
+#endif // ANALYSISWORKER_H
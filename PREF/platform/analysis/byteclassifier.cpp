@@ -0,0 +1,93 @@
+#include "byteclassifier.h"
+
+#if defined(PREF_SIMD_X86) && defined(_MSC_VER)
+    #include <intrin.h>
+    #include <immintrin.h>
+#endif
+
+ByteClassifier::Kernel ByteClassifier::kernel()
+{
+    static const Kernel kernel = ByteClassifier::detectKernel();
+    return kernel;
+}
+
+void ByteClassifier::classify(const unsigned char *data, uint64_t length, ByteClassifier::Masks *masks)
+{
+#ifdef PREF_SIMD_X86
+    Kernel kernel = ByteClassifier::kernel();
+
+    if(kernel == ByteClassifier::AVX2)
+    {
+        ByteClassifier::classifyAVX2(data, length, masks);
+        return;
+    }
+
+    if(kernel == ByteClassifier::SSE41)
+    {
+        ByteClassifier::classifySSE41(data, length, masks);
+        return;
+    }
+#endif
+
+    ByteClassifier::classifyScalar(data, length, masks);
+}
+
+ByteClassifier::Kernel ByteClassifier::detectKernel()
+{
+#ifdef PREF_SIMD_X86
+    #if defined(__GNUC__)
+        __builtin_cpu_init();
+
+        if(__builtin_cpu_supports("avx2"))
+            return ByteClassifier::AVX2;
+
+        if(__builtin_cpu_supports("sse4.1"))
+            return ByteClassifier::SSE41;
+    #elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        int maxleaf = info[0];
+
+        __cpuid(info, 1);
+        bool sse41 = (info[2] & (1 << 19)) != 0;
+        bool osymm = ((info[2] & (1 << 27)) != 0) && ((_xgetbv(0) & 0x6) == 0x6); /* OS saves YMM registers */
+
+        if(osymm && (maxleaf >= 7))
+        {
+            __cpuidex(info, 7, 0);
+
+            if(info[1] & (1 << 5))
+                return ByteClassifier::AVX2;
+        }
+
+        if(sse41)
+            return ByteClassifier::SSE41;
+    #endif
+#endif
+
+    return ByteClassifier::Scalar;
+}
+
+void ByteClassifier::classifyScalar(const unsigned char *data, uint64_t length, ByteClassifier::Masks *masks)
+{
+    for(uint64_t i = 0; i < length; i += 64)
+    {
+        uint64_t len = ((length - i) < 64) ? (length - i) : 64;
+        Masks& m = masks[i / 64];
+
+        m.Printable = m.Zero = m.High = m.Continuation = m.Lead2 = m.Lead3 = m.Lead4 = 0;
+
+        for(uint64_t j = 0; j < len; j++)
+        {
+            unsigned char b = data[i + j];
+
+            m.Printable |= static_cast<uint64_t>((b >= 0x20) && (b <= 0x7E)) << j;
+            m.Zero |= static_cast<uint64_t>(b == 0x00) << j;
+            m.High |= static_cast<uint64_t>(b >> 7) << j;
+            m.Continuation |= static_cast<uint64_t>((b >= 0x80) && (b <= 0xBF)) << j;
+            m.Lead2 |= static_cast<uint64_t>((b >= 0xC2) && (b <= 0xDF)) << j;
+            m.Lead3 |= static_cast<uint64_t>((b >= 0xE0) && (b <= 0xEF)) << j;
+            m.Lead4 |= static_cast<uint64_t>((b >= 0xF0) && (b <= 0xF4)) << j;
+        }
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef BYTECLASSIFIER_H
+#define BYTECLASSIFIER_H
+
+#include <cstdint>
+
+/*
+ * NOTE: This header is shared with the SSE4.1/AVX2 translation units,
+ * keep it free of Qt (or any other) inline code: the linker could pick
+ * the vectorized copy for the whole program.
+ *
+ * Every Masks entry covers 64 bytes, bit N is set when byte N matches.
+ */
+
+class ByteClassifier
+{
+    public:
+        struct Masks
+        {
+            uint64_t Printable;    /* 0x20 - 0x7E */
+            uint64_t Zero;         /* 0x00 */
+            uint64_t High;         /* 0x80 - 0xFF */
+            uint64_t Continuation; /* 0x80 - 0xBF */
+            uint64_t Lead2;        /* 0xC2 - 0xDF */
+            uint64_t Lead3;        /* 0xE0 - 0xEF */
+            uint64_t Lead4;        /* 0xF0 - 0xF4 */
+        };
+
+        enum Kernel { Scalar, SSE41, AVX2 };
+
+    public:
+        static Kernel kernel();
+        static void classify(const unsigned char* data, uint64_t length, Masks* masks);
+
+    private:
+        static Kernel detectKernel();
+        static void classifyScalar(const unsigned char* data, uint64_t length, Masks* masks);
+        static void classifySSE41(const unsigned char* data, uint64_t length, Masks* masks);
+        static void classifyAVX2(const unsigned char* data, uint64_t length, Masks* masks);
+};
+
+#endif // BYTECLASSIFIER_H
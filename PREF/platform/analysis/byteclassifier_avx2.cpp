@@ -0,0 +1,33 @@
+#include "byteclassifier.h"
+#include <immintrin.h>
+
+/* Subtracting the lower bound turns every range check into one unsigned compare */
+#define IN_RANGE(v, lo, span) _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(_mm256_sub_epi8(v, _mm256_set1_epi8(static_cast<char>(lo))), _mm256_set1_epi8(span)), _mm256_sub_epi8(v, _mm256_set1_epi8(static_cast<char>(lo)))))
+#define ADD_MASK(m, bits, shift) m |= static_cast<uint64_t>(static_cast<uint32_t>(bits)) << (shift)
+
+void ByteClassifier::classifyAVX2(const unsigned char *data, uint64_t length, ByteClassifier::Masks *masks)
+{
+    uint64_t i = 0;
+
+    for(; (i + 64) <= length; i += 64)
+    {
+        Masks& m = masks[i / 64];
+        m.Printable = m.Zero = m.High = m.Continuation = m.Lead2 = m.Lead3 = m.Lead4 = 0;
+
+        for(int j = 0; j < 2; j++)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + (j * 32)));
+
+            ADD_MASK(m.Printable, IN_RANGE(v, 0x20, 0x5E), j * 32);
+            ADD_MASK(m.Zero, _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_setzero_si256())), j * 32);
+            ADD_MASK(m.High, _mm256_movemask_epi8(v), j * 32);
+            ADD_MASK(m.Continuation, IN_RANGE(v, 0x80, 0x3F), j * 32);
+            ADD_MASK(m.Lead2, IN_RANGE(v, 0xC2, 0x1D), j * 32);
+            ADD_MASK(m.Lead3, IN_RANGE(v, 0xE0, 0x0F), j * 32);
+            ADD_MASK(m.Lead4, IN_RANGE(v, 0xF0, 0x04), j * 32);
+        }
+    }
+
+    if(i < length)
+        ByteClassifier::classifyScalar(data + i, length - i, masks + (i / 64));
+}
@@ -0,0 +1,33 @@
+#include "byteclassifier.h"
+#include <smmintrin.h>
+
+/* Subtracting the lower bound turns every range check into one unsigned compare */
+#define IN_RANGE(v, lo, span) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(_mm_sub_epi8(v, _mm_set1_epi8(static_cast<char>(lo))), _mm_set1_epi8(span)), _mm_sub_epi8(v, _mm_set1_epi8(static_cast<char>(lo)))))
+#define ADD_MASK(m, bits, shift) m |= static_cast<uint64_t>(static_cast<uint16_t>(bits)) << (shift)
+
+void ByteClassifier::classifySSE41(const unsigned char *data, uint64_t length, ByteClassifier::Masks *masks)
+{
+    uint64_t i = 0;
+
+    for(; (i + 64) <= length; i += 64)
+    {
+        Masks& m = masks[i / 64];
+        m.Printable = m.Zero = m.High = m.Continuation = m.Lead2 = m.Lead3 = m.Lead4 = 0;
+
+        for(int j = 0; j < 4; j++)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + (j * 16)));
+
+            ADD_MASK(m.Printable, IN_RANGE(v, 0x20, 0x5E), j * 16);
+            ADD_MASK(m.Zero, _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())), j * 16);
+            ADD_MASK(m.High, _mm_movemask_epi8(v), j * 16);
+            ADD_MASK(m.Continuation, IN_RANGE(v, 0x80, 0x3F), j * 16);
+            ADD_MASK(m.Lead2, IN_RANGE(v, 0xC2, 0x1D), j * 16);
+            ADD_MASK(m.Lead3, IN_RANGE(v, 0xE0, 0x0F), j * 16);
+            ADD_MASK(m.Lead4, IN_RANGE(v, 0xF0, 0x04), j * 16);
+        }
+    }
+
+    if(i < length)
+        ByteClassifier::classifyScalar(data + i, length - i, masks + (i / 64));
+}
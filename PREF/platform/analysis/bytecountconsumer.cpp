@@ -0,0 +1,77 @@
+#include "bytecountconsumer.h"
+#include "bytecounter.h"
+#include <algorithm>
+
+ByteCountConsumer::ByteCountConsumer(QObject *parent) : AnalysisConsumer(parent), _size(0)
+{
+
+}
+
+const ByteElaborator::CountResult &ByteCountConsumer::result() const
+{
+    return this->_result;
+}
+
+double ByteCountConsumer::entropy() const
+{
+    return Algorithm::entropy(this->_result, this->_size);
+}
+
+integer_t ByteCountConsumer::size() const
+{
+    return this->_size;
+}
+
+bool ByteCountConsumer::isParallel() const
+{
+    return true;
+}
+
+void ByteCountConsumer::begin(integer_t size)
+{
+    AnalysisConsumer::begin(size);
+    this->_size = size;
+}
+
+void ByteCountConsumer::prepareChunks(int count)
+{
+    this->_chunkcounts.fill(0, count * 256);
+}
+
+void ByteCountConsumer::consumeChunk(int chunk, integer_t, const uchar *data, integer_t length)
+{
+    ByteCounter::count(this->_chunkcounts.data() + (chunk * 256), data, length);
+}
+
+void ByteCountConsumer::end()
+{
+    uint64_t counts[256] = { 0 };
+
+    for(int i = 0; i < this->_chunkcounts.size(); i++) /* Integer sums: merge order doesn't affect the result */
+        counts[i % 256] += this->_chunkcounts[i];
+
+    this->_chunkcounts.clear();
+    this->_result.Counts.assign(counts, counts + 256);
+    this->_result.MaxCount = *std::max_element(counts, counts + 256);
+}
+
+bool ByteCountConsumer::update(integer_t, const QByteArray &before, const QByteArray &after)
+{
+    if(this->_result.Counts.size() != 256)
+        return false;
+
+    const uchar* olddata = reinterpret_cast<const uchar*>(before.constData());
+    const uchar* newdata = reinterpret_cast<const uchar*>(after.constData());
+
+    for(int i = 0; i < before.size(); i++)
+    {
+        if(olddata[i] == newdata[i])
+            continue;
+
+        this->_result.Counts[olddata[i]]--;
+        this->_result.Counts[newdata[i]]++;
+    }
+
+    this->_result.MaxCount = *std::max_element(this->_result.Counts.begin(), this->_result.Counts.end());
+    return true;
+}
@@ -0,0 +1,37 @@
+#ifndef BYTECOUNTCONSUMER_H
+#define BYTECOUNTCONSUMER_H
+
+#include <QVector>
+#include <cstdint>
+#include <support/byteelaborator.h>
+#include <chart/histogramchart.h>
+#include "analysisconsumer.h"
+
+using namespace PrefLib::Chart;
+using namespace PrefLib::Support;
+
+class ByteCountConsumer : public AnalysisConsumer
+{
+    Q_OBJECT
+
+    public:
+        explicit ByteCountConsumer(QObject *parent = 0);
+        const ByteElaborator::CountResult& result() const;
+        double entropy() const;
+        integer_t size() const;
+
+    public:
+        virtual bool isParallel() const;
+        virtual void begin(integer_t size);
+        virtual void prepareChunks(int count);
+        virtual void consumeChunk(int chunk, integer_t, const uchar* data, integer_t length);
+        virtual void end();
+        virtual bool update(integer_t, const QByteArray& before, const QByteArray& after);
+
+    private:
+        ByteElaborator::CountResult _result;
+        QVector<uint64_t> _chunkcounts; /* 256 bins per chunk */
+        integer_t _size;
+};
+
+#endif // BYTECOUNTCONSUMER_H
@@ -0,0 +1,60 @@
+#include "bytecounter.h"
+#include <cstring>
+
+const uint64_t ByteCounter::SMALL_LENGTH = 0x400;
+const uint64_t ByteCounter::SEGMENT_SIZE = 0x40000000; /* Keeps the 32 bit tables from overflowing */
+
+void ByteCounter::count(uint64_t *counts, const unsigned char *data, uint64_t length)
+{
+    if(length < ByteCounter::SMALL_LENGTH) /* Clearing and merging the tables would cost more than counting */
+    {
+        ByteCounter::countSmall(counts, data, length);
+        return;
+    }
+
+    ByteCounter::countTables(counts, data, length);
+}
+
+void ByteCounter::countSmall(uint64_t *counts, const unsigned char *data, uint64_t length)
+{
+    for(uint64_t i = 0; i < length; i++)
+        counts[data[i]]++;
+}
+
+void ByteCounter::countTables(uint64_t *counts, const unsigned char *data, uint64_t length)
+{
+    uint32_t tables[4][256];
+
+    while(length)
+    {
+        uint64_t len = (length < ByteCounter::SEGMENT_SIZE) ? length : ByteCounter::SEGMENT_SIZE;
+        uint64_t i = 0;
+
+        std::memset(tables, 0, sizeof(tables));
+
+        /* Consecutive bytes land in different tables: repeated values don't serialize on the same counter */
+        for(; (i + 8) <= len; i += 8)
+        {
+            uint64_t v;
+            std::memcpy(&v, data + i, sizeof(uint64_t));
+
+            tables[0][v & 0xFF]++;
+            tables[1][(v >> 8) & 0xFF]++;
+            tables[2][(v >> 16) & 0xFF]++;
+            tables[3][(v >> 24) & 0xFF]++;
+            tables[0][(v >> 32) & 0xFF]++;
+            tables[1][(v >> 40) & 0xFF]++;
+            tables[2][(v >> 48) & 0xFF]++;
+            tables[3][(v >> 56) & 0xFF]++;
+        }
+
+        for(; i < len; i++)
+            tables[0][data[i]]++;
+
+        for(int j = 0; j < 256; j++)
+            counts[j] += static_cast<uint64_t>(tables[0][j]) + tables[1][j] + tables[2][j] + tables[3][j];
+
+        data += len;
+        length -= len;
+    }
+}
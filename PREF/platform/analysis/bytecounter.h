@@ -0,0 +1,20 @@
+#ifndef BYTECOUNTER_H
+#define BYTECOUNTER_H
+
+#include <cstdint>
+
+class ByteCounter
+{
+    public:
+        static void count(uint64_t* counts, const unsigned char* data, uint64_t length);
+
+    private:
+        static void countSmall(uint64_t* counts, const unsigned char* data, uint64_t length);
+        static void countTables(uint64_t* counts, const unsigned char* data, uint64_t length);
+
+    private:
+        static const uint64_t SMALL_LENGTH;
+        static const uint64_t SEGMENT_SIZE;
+};
+
+#endif // BYTECOUNTER_H
@@ -0,0 +1,149 @@
+#include "categorymapconsumer.h"
+#include "bytecounter.h"
+#include <algorithm>
+#include <cstring>
+
+const integer_t CategoryMapConsumer::MAX_BLOCKS = 0x40000;
+const integer_t CategoryMapConsumer::MIN_BLOCK_SIZE = 0x1000;
+
+CategoryMapConsumer::CategoryMapConsumer(QObject *parent) : WindowConsumer(parent), _size(0)
+{
+    this->_pyramid.resize(1);
+}
+
+const CategoryMapConsumer::BlockList &CategoryMapConsumer::blocks() const
+{
+    return this->_pyramid.first();
+}
+
+const CategoryMapConsumer::Pyramid &CategoryMapConsumer::pyramid() const
+{
+    return this->_pyramid;
+}
+
+bool CategoryMapConsumer::refreshBlocks(QHexDocument *document, integer_t offset, integer_t length)
+{
+    if((document->length() != this->_size) || this->blocks().isEmpty()) /* Blocks would move */
+        return false;
+
+    if(!length)
+        return true;
+
+    integer_t first = offset / this->windowSize();
+    integer_t last = qMin((offset + length - 1) / this->windowSize(), static_cast<integer_t>(this->blocks().size() - 1));
+
+    for(integer_t i = first; i <= last; i++) /* Edited blocks are small enough to be counted again */
+    {
+        integer_t start = i * this->windowSize();
+        QByteArray data = document->read(start, qMin(this->windowSize(), this->_size - start));
+        uint64_t counts[256] = { 0 };
+
+        ByteCounter::count(counts, reinterpret_cast<const uchar*>(data.constData()), data.size());
+        this->window(i, start, counts, data.size());
+    }
+
+    for(int i = 1; i < this->_pyramid.size(); i++)
+    {
+        first >>= 1;
+        last >>= 1;
+        this->buildLevel(i, first, last);
+    }
+
+    return true;
+}
+
+CategoryMapConsumer::Category CategoryMapConsumer::category(uchar b)
+{
+    if(!b)
+        return CategoryMapConsumer::Zero;
+
+    if(b == 0xFF)
+        return CategoryMapConsumer::Full;
+
+    if(b >= 0x80)
+        return CategoryMapConsumer::Extended;
+
+    if(((b >= 0x20) && (b < 0x7F)) || (b == '\t') || (b == '\n') || (b == '\r'))
+        return CategoryMapConsumer::Printable;
+
+    return CategoryMapConsumer::Control;
+}
+
+void CategoryMapConsumer::begin(integer_t size)
+{
+    WindowConsumer::begin(size);
+
+    this->_size = size;
+    this->_pyramid.clear();
+    this->_pyramid.resize(1);
+    this->_pyramid[0].resize(this->windowCount());
+}
+
+void CategoryMapConsumer::end()
+{
+    WindowConsumer::end();
+
+    /* Built in the analysis thread: the navigator only looks nodes up */
+    while(this->_pyramid.last().size() > 1)
+    {
+        integer_t count = this->_pyramid.last().size();
+
+        this->_pyramid.append(BlockList());
+        this->_pyramid.last().resize((count + 1) / 2);
+        this->buildLevel(this->_pyramid.size() - 1, 0, this->_pyramid.last().size() - 1);
+    }
+}
+
+integer_t CategoryMapConsumer::calculateWindowSize(integer_t size) const
+{
+    integer_t blocksize = CategoryMapConsumer::MIN_BLOCK_SIZE;
+
+    while((blocksize * CategoryMapConsumer::MAX_BLOCKS) < size)
+        blocksize <<= 1;
+
+    return blocksize;
+}
+
+void CategoryMapConsumer::window(integer_t index, integer_t, const uint64_t *counts, integer_t size)
+{
+    uint64_t categories[CategoryMapConsumer::CategoryCount] = { 0 };
+
+    for(int i = 0; i < 256; i++)
+        categories[CategoryMapConsumer::category(i)] += counts[i];
+
+    BlockInfo& bi = this->_pyramid[0][index];
+    bi.Category = std::max_element(categories, categories + CategoryMapConsumer::CategoryCount) - categories;
+    bi.Entropy = WindowConsumer::entropy(counts, size);
+
+    for(int i = 0; i < CategoryMapConsumer::CategoryCount; i++)
+        bi.Categories[i] = size ? static_cast<float>(categories[i]) / static_cast<float>(size) : 0.0f;
+}
+
+void CategoryMapConsumer::buildLevel(int level, integer_t first, integer_t last)
+{
+    const BlockList& children = this->_pyramid[level - 1];
+    BlockList& nodes = this->_pyramid[level];
+
+    for(integer_t i = first; i <= last; i++)
+    {
+        integer_t child = i * 2;
+        CategoryMapConsumer::mergeBlocks(nodes[i], children[child], ((child + 1) < static_cast<integer_t>(children.size())) ? &children[child + 1] : NULL);
+    }
+}
+
+void CategoryMapConsumer::mergeBlocks(BlockInfo &bi, const BlockInfo &bi1, const BlockInfo *bi2)
+{
+    if(!bi2)
+    {
+        bi = bi1;
+        return;
+    }
+
+    /* Blocks are averaged: only the last one of the file can be shorter */
+    bi.Entropy = (bi1.Entropy + bi2->Entropy) / 2.0f;
+
+    for(int i = 0; i < CategoryMapConsumer::CategoryCount; i++)
+        bi.Categories[i] = (bi1.Categories[i] + bi2->Categories[i]) / 2.0f;
+
+    bi.Category = std::max_element(bi.Categories, bi.Categories + CategoryMapConsumer::CategoryCount) - bi.Categories;
+}
@@ -0,0 +1,50 @@
+#ifndef CATEGORYMAPCONSUMER_H
+#define CATEGORYMAPCONSUMER_H
+
+#include <QVector>
+#include "windowconsumer.h"
+
+class CategoryMapConsumer : public WindowConsumer
+{
+    Q_OBJECT
+
+    public:
+        enum Category { Zero = 0, Control, Printable, Extended, Full, CategoryCount };
+
+        struct BlockInfo
+        {
+            uchar Category;                  /* Dominant one */
+            float Entropy;
+            float Categories[CategoryCount]; /* Share of every category */
+        };
+
+        typedef QVector<BlockInfo> BlockList;
+        typedef QVector<BlockList> Pyramid;
+
+    public:
+        explicit CategoryMapConsumer(QObject *parent = 0);
+        const BlockList& blocks() const;
+        const Pyramid& pyramid() const;
+        bool refreshBlocks(QHexDocument* document, integer_t offset, integer_t length);
+        static Category category(uchar b);
+
+    public:
+        virtual void begin(integer_t size);
+        virtual void end();
+
+    protected:
+        virtual integer_t calculateWindowSize(integer_t size) const;
+        virtual void window(integer_t index, integer_t, const uint64_t* counts, integer_t size);
+
+    private:
+        void buildLevel(int level, integer_t first, integer_t last);
+        static void mergeBlocks(BlockInfo& bi, const BlockInfo& bi1, const BlockInfo* bi2);
+
+    private:
+        static const integer_t MAX_BLOCKS;
+        static const integer_t MIN_BLOCK_SIZE;
+        Pyramid _pyramid; /* Level 0 holds the blocks, every next level halves the previous one */
+        integer_t _size;
+};
+
+#endif // CATEGORYMAPCONSUMER_H
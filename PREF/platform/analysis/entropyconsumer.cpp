@@ -0,0 +1,70 @@
+#include "entropyconsumer.h"
+#include <numeric>
+#include <cstring>
+
+const integer_t EntropyConsumer::POINT_COUNT = 1024;
+const integer_t EntropyConsumer::MIN_WINDOW_SIZE = 256;
+
+EntropyConsumer::EntropyConsumer(QObject *parent) : WindowConsumer(parent)
+{
+
+}
+
+const QVector<QPointF> &EntropyConsumer::points() const
+{
+    return this->_points;
+}
+
+void EntropyConsumer::begin(integer_t size)
+{
+    WindowConsumer::begin(size);
+
+    this->_points.clear();
+    this->_points.resize(this->windowCount());
+    this->_windowcounts.fill(0, this->windowCount() * 256);
+}
+
+bool EntropyConsumer::update(integer_t offset, const QByteArray &before, const QByteArray &after)
+{
+    if(this->_windowcounts.isEmpty())
+        return false;
+
+    if(before.isEmpty())
+        return true;
+
+    const uchar* olddata = reinterpret_cast<const uchar*>(before.constData());
+    const uchar* newdata = reinterpret_cast<const uchar*>(after.constData());
+    integer_t windowsize = this->windowSize();
+
+    for(int i = 0; i < before.size(); i++)
+    {
+        if(olddata[i] == newdata[i])
+            continue;
+
+        uint64_t* counts = this->_windowcounts.data() + (((offset + i) / windowsize) * 256);
+        counts[olddata[i]]--;
+        counts[newdata[i]]++;
+    }
+
+    /* Only the windows touched by the edit need a new entropy value */
+    for(integer_t index = offset / windowsize; index <= (offset + before.size() - 1) / windowsize; index++)
+    {
+        const uint64_t* counts = this->_windowcounts.constData() + (index * 256);
+        integer_t size = std::accumulate(counts, counts + 256, static_cast<uint64_t>(0));
+
+        this->_points[index].setY(WindowConsumer::entropy(counts, size));
+    }
+
+    return true;
+}
+
+integer_t EntropyConsumer::calculateWindowSize(integer_t size) const
+{
+    return qMax(EntropyConsumer::MIN_WINDOW_SIZE, (size + EntropyConsumer::POINT_COUNT - 1) / EntropyConsumer::POINT_COUNT);
+}
+
+void EntropyConsumer::window(integer_t index, integer_t offset, const uint64_t *counts, integer_t size)
+{
+    std::memcpy(this->_windowcounts.data() + (index * 256), counts, 256 * sizeof(uint64_t));
+    this->_points[index] = QPointF(offset, WindowConsumer::entropy(counts, size));
+}
@@ -0,0 +1,31 @@
+#ifndef ENTROPYCONSUMER_H
+#define ENTROPYCONSUMER_H
+
+#include <QVector>
+#include <QPointF>
+#include "windowconsumer.h"
+
+class EntropyConsumer : public WindowConsumer
+{
+    Q_OBJECT
+
+    public:
+        explicit EntropyConsumer(QObject *parent = 0);
+        const QVector<QPointF>& points() const;
+
+    public:
+        virtual void begin(integer_t size);
+        virtual bool update(integer_t offset, const QByteArray& before, const QByteArray& after);
+
+    protected:
+        virtual integer_t calculateWindowSize(integer_t size) const;
+        virtual void window(integer_t index, integer_t offset, const uint64_t* counts, integer_t size);
+
+    private:
+        static const integer_t POINT_COUNT;
+        static const integer_t MIN_WINDOW_SIZE;
+        QVector<QPointF> _points;
+        QVector<uint64_t> _windowcounts; /* 256 bins per window, kept for incremental updates */
+};
+
+#endif // ENTROPYCONSUMER_H
@@ -0,0 +1,91 @@
+#include "stringarena.h"
+
+StringArena::StringArena()
+{
+    this->_textoffsets.append(0);
+}
+
+bool StringArena::isEmpty() const
+{
+    return this->_matches.isEmpty();
+}
+
+int StringArena::size() const
+{
+    return this->_matches.size();
+}
+
+void StringArena::reserve(int count, int textlength)
+{
+    this->_matches.reserve(count);
+    this->_textoffsets.reserve(count + 1);
+    this->_text.reserve(textlength);
+}
+
+void StringArena::append(const StringScanner::Match &m, const uchar *data)
+{
+    int length = static_cast<int>(m.End - m.Start);
+
+    if(m.Encoding == StringScanner::Utf16LE) /* Only the ASCII range is matched: keep the low bytes */
+    {
+        int pos = this->_text.size();
+        this->_text.resize(pos + (length / 2));
+
+        char* p = this->_text.data() + pos;
+
+        for(int i = 0; i < length; i += 2)
+            *p++ = static_cast<char>(data[i]);
+    }
+    else /* ASCII and validated UTF-8 are stored as they are */
+        this->_text.append(reinterpret_cast<const char*>(data), length);
+
+    this->_matches.append(m);
+    this->_textoffsets.append(static_cast<quint32>(this->_text.size()));
+}
+
+const StringScanner::Match &StringArena::match(int i) const
+{
+    return this->_matches[i];
+}
+
+const char *StringArena::text(int i, int *length) const
+{
+    *length = static_cast<int>(this->_textoffsets[i + 1] - this->_textoffsets[i]);
+    return this->_text.constData() + this->_textoffsets[i];
+}
+
+QString StringArena::string(int i) const
+{
+    int length = 0;
+    const char* s = this->text(i, &length);
+    return QString::fromUtf8(s, length);
+}
+
+int StringArena::length(int i) const
+{
+    int length = 0;
+    const uchar* s = reinterpret_cast<const uchar*>(this->text(i, &length));
+
+    if(this->_matches[i].Encoding != StringScanner::Utf8)
+        return length;
+
+    int chars = 0;
+
+    for(int j = 0; j < length; j++)
+    {
+        if((s[j] & 0xC0) != 0x80) /* Continuation bytes don't start a character */
+            chars++;
+    }
+
+    return chars;
+}
+
+void StringArena::buildIndex()
+{
+    this->_index.build(this->_text.constData(), this->_textoffsets);
+}
+
+bool StringArena::candidates(const QByteArray &foldedtext, QVector<quint32> &result) const
+{
+    return this->_index.candidates(foldedtext, result);
+}
@@ -0,0 +1,32 @@
+#ifndef STRINGARENA_H
+#define STRINGARENA_H
+
+#include <QVector>
+#include <QByteArray>
+#include <QString>
+#include "stringscanner.h"
+#include "stringindex.h"
+
+class StringArena
+{
+    public:
+        StringArena();
+        bool isEmpty() const;
+        int size() const;
+        void reserve(int count, int textlength);
+        void append(const StringScanner::Match& m, const uchar* data);
+        const StringScanner::Match& match(int i) const;
+        const char* text(int i, int* length) const;
+        QString string(int i) const;
+        int length(int i) const;
+        void buildIndex();
+        bool candidates(const QByteArray& foldedtext, QVector<quint32>& result) const;
+
+    private:
+        StringScanner::MatchList _matches;
+        QByteArray _text;              /* Every string, UTF-8 encoded and packed back to back */
+        QVector<quint32> _textoffsets; /* One more than _matches: string i is [_textoffsets[i], _textoffsets[i + 1]) */
+        StringIndex _index;
+};
+
+#endif // STRINGARENA_H
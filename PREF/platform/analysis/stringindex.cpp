@@ -0,0 +1,140 @@
+#include "stringindex.h"
+#include <QPair>
+#include <algorithm>
+#include <iterator>
+
+#define FOLD_ASCII(c) ((((c) >= 'A') && ((c) <= 'Z')) ? ((c) | 0x20) : (c))
+
+StringIndex::StringIndex()
+{
+    this->_starts.append(0);
+}
+
+void StringIndex::build(const char *text, const QVector<quint32> &textoffsets)
+{
+    QVector<quint64> entries; /* Trigram << 32 | String index */
+    entries.reserve(textoffsets.last());
+
+    for(int i = 0; i < textoffsets.size() - 1; i++)
+    {
+        const uchar* p = reinterpret_cast<const uchar*>(text) + textoffsets[i];
+        const uchar* end = reinterpret_cast<const uchar*>(text) + textoffsets[i + 1];
+        quint32 last = 0xFFFFFFFF;
+
+        for(; (p + 3) <= end; p++)
+        {
+            if((p[0] | p[1] | p[2]) & 0x80) /* Only ASCII trigrams are folded the same way as queries */
+                continue;
+
+            quint32 t = StringIndex::trigram(p);
+
+            if(t == last) /* Runs like "AAAA" */
+                continue;
+
+            entries.append((static_cast<quint64>(t) << 32) | static_cast<quint64>(i));
+            last = t;
+        }
+    }
+
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+    this->_trigrams.clear();
+    this->_starts.clear();
+    this->_postings.clear();
+    this->_postings.reserve(entries.size());
+
+    foreach(quint64 entry, entries)
+    {
+        quint32 t = static_cast<quint32>(entry >> 32);
+
+        if(this->_trigrams.isEmpty() || (this->_trigrams.last() != t))
+        {
+            this->_trigrams.append(t);
+            this->_starts.append(static_cast<quint32>(this->_postings.size()));
+        }
+
+        this->_postings.append(static_cast<quint32>(entry));
+    }
+
+    this->_starts.append(static_cast<quint32>(this->_postings.size()));
+    this->_trigrams.squeeze();
+    this->_starts.squeeze();
+}
+
+bool StringIndex::candidates(const QByteArray &foldedtext, QVector<quint32> &result) const
+{
+    QVector<quint32> trigrams;
+    const uchar* p = reinterpret_cast<const uchar*>(foldedtext.constData());
+
+    for(int i = 0; (i + 3) <= foldedtext.size(); i++)
+    {
+        if(!((p[i] | p[i + 1] | p[i + 2]) & 0x80))
+            trigrams.append(StringIndex::trigram(p + i));
+    }
+
+    if(trigrams.isEmpty()) /* Nothing to look up: every string is a candidate */
+        return false;
+
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+    QVector< QPair<const quint32*, const quint32*> > lists;
+    result.clear();
+
+    foreach(quint32 t, trigrams)
+    {
+        const quint32 *begin = NULL, *end = NULL;
+
+        if(!this->postings(t, &begin, &end))
+            return true;
+
+        lists.append(qMakePair(begin, end));
+    }
+
+    /* Intersect starting from the rarest trigram, the candidate list only shrinks */
+    std::sort(lists.begin(), lists.end(), [](const QPair<const quint32*, const quint32*>& l1, const QPair<const quint32*, const quint32*>& l2) {
+        return (l1.second - l1.first) < (l2.second - l2.first);
+    });
+
+    QVector<quint32> intersection;
+    result.reserve(lists.first().second - lists.first().first);
+    std::copy(lists.first().first, lists.first().second, std::back_inserter(result));
+
+    for(int i = 1; (i < lists.size()) && !result.isEmpty(); i++)
+    {
+        intersection.clear();
+        std::set_intersection(result.begin(), result.end(), lists[i].first, lists[i].second, std::back_inserter(intersection));
+        result.swap(intersection);
+    }
+
+    return true;
+}
+
+QByteArray StringIndex::fold(const QByteArray &text)
+{
+    QByteArray folded = text;
+
+    for(int i = 0; i < folded.size(); i++)
+        folded[i] = static_cast<char>(FOLD_ASCII(static_cast<uchar>(folded[i])));
+
+    return folded;
+}
+
+quint32 StringIndex::trigram(const uchar *p)
+{
+    return (static_cast<quint32>(FOLD_ASCII(p[0])) << 16) | (static_cast<quint32>(FOLD_ASCII(p[1])) << 8) | static_cast<quint32>(FOLD_ASCII(p[2]));
+}
+
+bool StringIndex::postings(quint32 trigram, const quint32 **begin, const quint32 **end) const
+{
+    QVector<quint32>::const_iterator it = std::lower_bound(this->_trigrams.begin(), this->_trigrams.end(), trigram);
+
+    if((it == this->_trigrams.end()) || (*it != trigram))
+        return false;
+
+    int i = static_cast<int>(it - this->_trigrams.begin());
+    *begin = this->_postings.constData() + this->_starts[i];
+    *end = this->_postings.constData() + this->_starts[i + 1];
+    return true;
+}
@@ -0,0 +1,25 @@
+#ifndef STRINGINDEX_H
+#define STRINGINDEX_H
+
+#include <QVector>
+#include <QByteArray>
+
+class StringIndex
+{
+    public:
+        StringIndex();
+        void build(const char* text, const QVector<quint32>& textoffsets);
+        bool candidates(const QByteArray& foldedtext, QVector<quint32>& result) const;
+        static QByteArray fold(const QByteArray& text);
+
+    private:
+        static quint32 trigram(const uchar* p);
+        bool postings(quint32 trigram, const quint32** begin, const quint32** end) const;
+
+    private:
+        QVector<quint32> _trigrams; /* Sorted, ASCII case folded */
+        QVector<quint32> _starts;   /* One more than _trigrams: postings of trigram i are [_starts[i], _starts[i + 1]) */
+        QVector<quint32> _postings; /* String indices, sorted for each trigram */
+};
+
+#endif // STRINGINDEX_H
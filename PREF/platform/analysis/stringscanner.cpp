@@ -0,0 +1,321 @@
+#include "stringscanner.h"
+#include <QtAlgorithms>
+#include <cstring>
+
+#define VALID_BITS(n) (((n) == 64) ? ~Q_UINT64_C(0) : ((Q_UINT64_C(1) << (n)) - 1))
+#define SHIFT_IN(m, history, k) (((m) << (k)) | ((history) >> (64 - (k)))) /* Bit N becomes byte N - k, 0 < k < 64 */
+#define PUSH_HISTORY(history, m, n) history = (((n) == 64) ? (m) : (((history) >> (n)) | ((m) << (64 - (n)))))
+
+const integer_t StringScanner::WINDOW_SIZE = 0x1000;
+
+/*
+ * Bytes are classified 64 at a time by ByteClassifier and runs are extracted
+ * from the resulting bit masks: the cost depends on the number of strings
+ * long enough to be reported, not on the number of bytes.
+ *
+ * A sync point is a byte that ends every run whatever the previous state was:
+ * a control character, or the second byte of a 00 00 pair.
+ * Scanning from a sync point gives the same result as scanning from the start
+ * of the file, which lets chunks be scanned independently.
+ *
+ * UTF-8 sequences are validated by looking at the next word, so the last
+ * word seen is processed on the next scan() or flush() call: incomplete words
+ * are held back until enough bytes arrive.
+ */
+
+StringScanner::StringScanner(int encodings, integer_t minlength): _encodings(encodings), _minlength(qMax(minlength, static_cast<integer_t>(1)))
+{
+    this->reset(0);
+}
+
+void StringScanner::reset(integer_t offset)
+{
+    this->_offset = offset;
+    this->_wordbase = offset;
+    this->_lastsync = offset;
+    this->_previouszero = false;
+    this->_carrylength = 0;
+    this->_haspending = false;
+    this->_texthistory = 0;
+    this->_leadhistory[0] = this->_leadhistory[1] = this->_leadhistory[2] = 0;
+    this->_textstart = offset;
+    this->_textchars = 0;
+    this->_textmultibyte = false;
+    this->_intext = false;
+    this->_printablehistory = 0;
+    this->_widehistory = 0;
+
+    for(int i = 0; i < 2; i++)
+    {
+        this->_wide[i].First = offset + ((offset & 1) != static_cast<integer_t>(i)); /* First position with this alignment */
+        this->_wide[i].Last = 0;
+        this->_wide[i].Open = false;
+    }
+}
+
+void StringScanner::scan(const uchar *data, integer_t length, StringScanner::MatchList &matches)
+{
+    integer_t i = 0;
+
+    if(this->_carrylength)
+    {
+        i = qMin(static_cast<integer_t>(64 - this->_carrylength), length);
+        std::memcpy(this->_carry + this->_carrylength, data, i);
+        this->_carrylength += i;
+
+        if(this->_carrylength == 64)
+        {
+            this->scanWords(this->_carry, 64, matches);
+            this->_carrylength = 0;
+        }
+    }
+
+    integer_t len = (length - i) & ~static_cast<integer_t>(63);
+    this->scanWords(data + i, len, matches);
+    i += len;
+
+    std::memcpy(this->_carry + this->_carrylength, data + i, length - i);
+    this->_carrylength += length - i;
+    this->_offset += length;
+}
+
+void StringScanner::flush(StringScanner::MatchList &matches)
+{
+    if(this->_carrylength)
+        this->scanWords(this->_carry, this->_carrylength, matches);
+
+    if(this->_haspending)
+    {
+        this->processWord(this->_pending, 0, matches);
+        this->_haspending = false;
+    }
+
+    if(this->_intext)
+        this->appendMatch(this->_textstart, this->_offset, this->_textchars, this->_textmultibyte ? StringScanner::Utf8 : StringScanner::Ascii, matches);
+
+    for(int i = 0; i < 2; i++)
+    {
+        const WideRun& run = this->_wide[i];
+
+        if(run.Open)
+            this->appendMatch(run.First - 1, run.Last + 1, ((run.Last - run.First) / 2) + 1, StringScanner::Utf16LE, matches);
+    }
+
+    this->reset(this->_offset);
+}
+
+integer_t StringScanner::lastSync() const
+{
+    return this->_lastsync;
+}
+
+integer_t StringScanner::findSync(const uchar *data, integer_t length, bool previouszero)
+{
+    ByteClassifier::Masks masks[StringScanner::WINDOW_SIZE / 64];
+
+    for(integer_t i = 0; i < length; i += StringScanner::WINDOW_SIZE)
+    {
+        integer_t len = qMin(StringScanner::WINDOW_SIZE, length - i);
+        ByteClassifier::classify(data + i, len, masks);
+
+        for(integer_t w = 0; (w * 64) < len; w++)
+        {
+            const ByteClassifier::Masks& m = masks[w];
+            int n = static_cast<int>(qMin(static_cast<integer_t>(64), len - (w * 64)));
+            quint64 control = VALID_BITS(n) & ~(m.Printable | m.Zero | m.High);
+            quint64 sync = control | (m.Zero & ((m.Zero << 1) | previouszero));
+
+            if(sync)
+                return i + (w * 64) + qCountTrailingZeroBits(sync);
+
+            previouszero = (m.Zero >> (n - 1)) & 1;
+        }
+    }
+
+    return length;
+}
+
+void StringScanner::scanWords(const uchar *data, integer_t length, StringScanner::MatchList &matches)
+{
+    ByteClassifier::Masks masks[StringScanner::WINDOW_SIZE / 64];
+
+    for(integer_t i = 0; i < length; i += StringScanner::WINDOW_SIZE)
+    {
+        integer_t len = qMin(StringScanner::WINDOW_SIZE, length - i);
+        ByteClassifier::classify(data + i, len, masks);
+
+        for(integer_t w = 0; (w * 64) < len; w++)
+            this->pushWord(masks[w], this->_wordbase + i + (w * 64), static_cast<int>(qMin(static_cast<integer_t>(64), len - (w * 64))), matches);
+    }
+
+    this->_wordbase += length;
+}
+
+void StringScanner::pushWord(const ByteClassifier::Masks &masks, integer_t base, int length, StringScanner::MatchList &matches)
+{
+    quint64 control = VALID_BITS(length) & ~(masks.Printable | masks.Zero | masks.High);
+    quint64 sync = control | (masks.Zero & ((masks.Zero << 1) | this->_previouszero));
+
+    if(sync)
+        this->_lastsync = base + 63 - qCountLeadingZeroBits(sync);
+
+    this->_previouszero = (masks.Zero >> (length - 1)) & 1;
+
+    if(this->_haspending)
+        this->processWord(this->_pending, masks.Continuation, matches);
+
+    this->_pending.Masks = masks;
+    this->_pending.Base = base;
+    this->_pending.Length = length;
+    this->_haspending = true;
+}
+
+void StringScanner::processWord(const StringScanner::Word &word, quint64 nextcontinuation, StringScanner::MatchList &matches)
+{
+    quint64 valid = VALID_BITS(word.Length);
+
+    if(this->_encodings & (StringScanner::Ascii | StringScanner::Utf8))
+        this->scanText(word, valid, nextcontinuation, matches);
+
+    if(this->_encodings & StringScanner::Utf16LE)
+        this->scanWide(word, valid, matches);
+
+    PUSH_HISTORY(this->_printablehistory, word.Masks.Printable, word.Length);
+}
+
+void StringScanner::scanText(const StringScanner::Word &word, quint64 valid, quint64 nextcontinuation, StringScanner::MatchList &matches)
+{
+    const ByteClassifier::Masks& m = word.Masks;
+    quint64 text = m.Printable, leads = 0;
+
+    if(this->_encodings & StringScanner::Utf8)
+    {
+        /* Continuation bytes following each position, the next word supplies the last three */
+        quint64 cont = m.Continuation | ((word.Length < 64) ? (nextcontinuation << word.Length) : 0);
+        quint64 contnext = (word.Length < 64) ? (nextcontinuation >> (64 - word.Length)) : nextcontinuation;
+        quint64 c1 = (cont >> 1) | (contnext << 63), c2 = (cont >> 2) | (contnext << 62), c3 = (cont >> 3) | (contnext << 61);
+        quint64 seq3 = m.Lead3 & c1 & c2, seq4 = m.Lead4 & c1 & c2 & c3;
+
+        leads = ((m.Lead2 & c1) | seq3 | seq4) & valid;
+        text |= valid & (leads | SHIFT_IN(leads, this->_leadhistory[0], 1) | SHIFT_IN(seq3 | seq4, this->_leadhistory[1], 2) | SHIFT_IN(seq4, this->_leadhistory[2], 3));
+
+        PUSH_HISTORY(this->_leadhistory[0], leads, word.Length);
+        PUSH_HISTORY(this->_leadhistory[1], (seq3 | seq4) & valid, word.Length);
+        PUSH_HISTORY(this->_leadhistory[2], seq4 & valid, word.Length);
+    }
+
+    quint64 chars = m.Printable | leads; /* Continuation bytes are not counted */
+    quint64 ends = valid & ~text & ((text << 1) | (this->_texthistory >> 63));
+
+    if(this->_minlength < 64) /* Only runs with at least minlength bytes can have minlength characters */
+    {
+        for(integer_t k = 1; ends && (k <= this->_minlength); k++)
+            ends &= SHIFT_IN(text, this->_texthistory, k);
+    }
+
+    while(ends)
+    {
+        int e = qCountTrailingZeroBits(ends);
+        quint64 before = (Q_UINT64_C(1) << e) - 1, gaps = before & ~text;
+        ends &= ends - 1;
+
+        if(gaps)
+        {
+            quint64 run = before & ~((Q_UINT64_C(2) << (63 - qCountLeadingZeroBits(gaps))) - 1);
+            this->appendMatch(word.Base + 64 - qCountLeadingZeroBits(gaps), word.Base + e, qPopulationCount(chars & run), (leads & run) ? StringScanner::Utf8 : StringScanner::Ascii, matches);
+        }
+        else
+            this->appendMatch(this->_textstart, word.Base + e, this->_textchars + qPopulationCount(chars & before), (this->_textmultibyte || (leads & before)) ? StringScanner::Utf8 : StringScanner::Ascii, matches);
+    }
+
+    /* Remember the run that reaches the end of the word */
+    if((text >> (word.Length - 1)) & 1)
+    {
+        quint64 gaps = valid & ~text;
+
+        if(gaps)
+        {
+            quint64 run = valid & ~((Q_UINT64_C(2) << (63 - qCountLeadingZeroBits(gaps))) - 1);
+            this->_textstart = word.Base + 64 - qCountLeadingZeroBits(gaps);
+            this->_textchars = qPopulationCount(chars & run);
+            this->_textmultibyte = (leads & run) != 0;
+        }
+        else
+        {
+            this->_textchars += qPopulationCount(chars & valid);
+            this->_textmultibyte |= (leads != 0);
+        }
+
+        this->_intext = true;
+    }
+    else
+    {
+        this->_textstart = word.Base + word.Length;
+        this->_textchars = 0;
+        this->_textmultibyte = false;
+        this->_intext = false;
+    }
+
+    PUSH_HISTORY(this->_texthistory, text, word.Length);
+}
+
+void StringScanner::scanWide(const StringScanner::Word &word, quint64 valid, StringScanner::MatchList &matches)
+{
+    /* Bit N is set when a character ends at Base + N: a zero preceded by a printable byte */
+    quint64 wide = valid & word.Masks.Zero & SHIFT_IN(word.Masks.Printable, this->_printablehistory, 1);
+
+    for(int i = 0; i < 2; i++)
+    {
+        quint64 alignment = valid & ((static_cast<int>(word.Base & 1) == i) ? Q_UINT64_C(0x5555555555555555) : Q_UINT64_C(0xAAAAAAAAAAAAAAAA));
+        WideRun& run = this->_wide[i];
+
+        if(!alignment)
+            continue;
+
+        quint64 ends = alignment & ~wide & SHIFT_IN(wide, this->_widehistory, 2);
+
+        if(this->_minlength < 32)
+        {
+            for(integer_t k = 1; ends && (k <= this->_minlength); k++)
+                ends &= SHIFT_IN(wide, this->_widehistory, 2 * k);
+        }
+
+        while(ends)
+        {
+            int e = qCountTrailingZeroBits(ends);
+            quint64 gaps = alignment & ~wide & ((Q_UINT64_C(1) << e) - 1);
+            integer_t first = gaps ? (word.Base + 63 - qCountLeadingZeroBits(gaps) + 2) : run.First;
+            ends &= ends - 1;
+
+            this->appendMatch(first - 1, word.Base + e - 1, (word.Base + e - first) / 2, StringScanner::Utf16LE, matches);
+        }
+
+        int last = 63 - qCountLeadingZeroBits(alignment);
+        quint64 gaps = alignment & ~wide;
+        run.Open = (wide >> last) & 1;
+
+        if(run.Open)
+        {
+            if(gaps)
+                run.First = word.Base + 63 - qCountLeadingZeroBits(gaps) + 2;
+
+            run.Last = word.Base + last;
+        }
+        else
+            run.First = word.Base + last + 2;
+    }
+
+    PUSH_HISTORY(this->_widehistory, wide, word.Length);
+}
+
+void StringScanner::appendMatch(integer_t start, integer_t end, integer_t chars, int encoding, StringScanner::MatchList &matches) const
+{
+    if((chars < this->_minlength) || !(this->_encodings & encoding))
+        return;
+
+    Match m;
+    m.Start = start;
+    m.End = end;
+    m.Encoding = encoding;
+    matches.append(m);
+}
@@ -0,0 +1,76 @@
+#ifndef STRINGSCANNER_H
+#define STRINGSCANNER_H
+
+#include <QVector>
+#include <qhexedit/document/qhexdocument.h>
+#include "byteclassifier.h"
+
+class StringScanner
+{
+    public:
+        enum Encoding { Ascii = 1, Utf8 = 2, Utf16LE = 4, AllEncodings = Ascii | Utf8 | Utf16LE };
+
+        struct Match
+        {
+            integer_t Start;
+            integer_t End;
+            int Encoding;
+        };
+
+        typedef QVector<Match> MatchList;
+
+    private:
+        struct Word
+        {
+            ByteClassifier::Masks Masks;
+            integer_t Base;
+            int Length;
+        };
+
+        struct WideRun
+        {
+            integer_t First; /* End of the first character */
+            integer_t Last;  /* End of the last character */
+            bool Open;
+        };
+
+    public:
+        StringScanner(int encodings = StringScanner::AllEncodings, integer_t minlength = 4);
+        void reset(integer_t offset);
+        void scan(const uchar* data, integer_t length, MatchList& matches);
+        void flush(MatchList& matches);
+        integer_t lastSync() const;
+        static integer_t findSync(const uchar* data, integer_t length, bool previouszero);
+
+    private:
+        void scanWords(const uchar* data, integer_t length, MatchList& matches);
+        void pushWord(const ByteClassifier::Masks& masks, integer_t base, int length, MatchList& matches);
+        void processWord(const Word& word, quint64 nextcontinuation, MatchList& matches);
+        void scanText(const Word& word, quint64 valid, quint64 nextcontinuation, MatchList& matches);
+        void scanWide(const Word& word, quint64 valid, MatchList& matches);
+        void appendMatch(integer_t start, integer_t end, integer_t chars, int encoding, MatchList& matches) const;
+
+    private:
+        static const integer_t WINDOW_SIZE;
+        int _encodings;
+        integer_t _minlength;
+        integer_t _offset;
+        integer_t _wordbase;
+        integer_t _lastsync;
+        bool _previouszero;
+        uchar _carry[64];  /* Words are only classified when complete */
+        int _carrylength;
+        Word _pending;
+        bool _haspending;
+        quint64 _texthistory;    /* Text bytes among the last 64 processed */
+        quint64 _leadhistory[3]; /* UTF-8 sequences of 2+, 3+ and 4 bytes */
+        integer_t _textstart;
+        integer_t _textchars;
+        bool _textmultibyte;
+        bool _intext;
+        quint64 _printablehistory;
+        quint64 _widehistory;
+        WideRun _wide[2]; /* One run per alignment */
+};
+
+#endif // STRINGSCANNER_H
@@ -0,0 +1,251 @@
+#include "stringsconsumer.h"
+
+static bool matchLessThan(const StringScanner::Match& m1, const StringScanner::Match& m2)
+{
+    return (m1.Start < m2.Start) || ((m1.Start == m2.Start) && (m1.End < m2.End));
+}
+
+static void sortMatches(StringScanner::MatchList::iterator begin, StringScanner::MatchList::iterator end)
+{
+    /* Matches are appended as runs complete: only the few ones overlapping a UTF-16 run are out of place */
+    for(StringScanner::MatchList::iterator it = begin; it != end; it++)
+    {
+        StringScanner::Match m = *it;
+        StringScanner::MatchList::iterator j = it;
+
+        for(; (j != begin) && matchLessThan(m, *(j - 1)); j--)
+            *j = *(j - 1);
+
+        *j = m;
+    }
+}
+
+const integer_t StringsConsumer::MIN_LENGTH = 4;
+const int StringsConsumer::MAX_SEAM_SIZE = 0x400000;
+
+StringsConsumer::StringsConsumer(QObject *parent) : AnalysisConsumer(parent), _seamoffset(0), _completedchunks(0), _pass(0), _encodings(StringScanner::AllEncodings), _minlength(StringsConsumer::MIN_LENGTH), _nextencodings(StringScanner::AllEncodings), _nextminlength(StringsConsumer::MIN_LENGTH)
+{
+
+}
+
+QVector<StringArena> StringsConsumer::takeStrings(int *pass)
+{
+    QMutexLocker locker(&this->_mutex);
+    QVector<StringArena> strings;
+
+    strings.swap(this->_pendingstrings);
+    *pass = this->_pass;
+    return strings;
+}
+
+int StringsConsumer::encodings() const
+{
+    QMutexLocker locker(&this->_mutex);
+    return this->_nextencodings;
+}
+
+integer_t StringsConsumer::minimumLength() const
+{
+    QMutexLocker locker(&this->_mutex);
+    return this->_nextminlength;
+}
+
+void StringsConsumer::setEncodings(int encodings)
+{
+    QMutexLocker locker(&this->_mutex);
+    this->_nextencodings = encodings;
+}
+
+void StringsConsumer::setMinimumLength(integer_t minlength)
+{
+    QMutexLocker locker(&this->_mutex);
+    this->_nextminlength = minlength;
+}
+
+bool StringsConsumer::isParallel() const
+{
+    return true;
+}
+
+void StringsConsumer::begin(integer_t size)
+{
+    AnalysisConsumer::begin(size);
+
+    QMutexLocker locker(&this->_mutex);
+    this->_pendingstrings.clear();
+    this->_pass++;
+    this->_encodings = this->_nextencodings; /* Settings never change in the middle of a pass */
+    this->_minlength = this->_nextminlength;
+    this->_seam.clear();
+    this->_seamoffset = 0;
+    this->_completedchunks = 0;
+}
+
+void StringsConsumer::prepareChunks(int count)
+{
+    ChunkState cs;
+    cs.Scanner = StringScanner(this->_encodings, this->_minlength);
+    cs.TailOffset = 0;
+    cs.Synced = false;
+    cs.PreviousZero = false;
+
+    this->_chunks.fill(cs, count);
+}
+
+void StringsConsumer::consumeChunk(int chunk, integer_t offset, const uchar *data, integer_t length)
+{
+    ChunkState& cs = this->_chunks[chunk];
+    integer_t start = 0;
+
+    if(!cs.Synced) /* The previous chunk decides what these bytes belong to, keep them for the seam */
+    {
+        start = StringScanner::findSync(data, length, cs.PreviousZero);
+
+        if(start == length)
+        {
+            cs.Head.append(reinterpret_cast<const char*>(data), length);
+            cs.PreviousZero = length && !data[length - 1];
+            return;
+        }
+
+        cs.Head.append(reinterpret_cast<const char*>(data), start + 1);
+        cs.Scanner.reset(offset + start);
+        cs.Synced = true;
+    }
+
+    cs.Scanner.scan(data + start, length - start, cs.Matches);
+    integer_t lastsync = cs.Scanner.lastSync();
+
+    if(lastsync >= offset)
+    {
+        cs.Tail = QByteArray(reinterpret_cast<const char*>(data + (lastsync - offset)), length - (lastsync - offset));
+        cs.TailOffset = lastsync;
+    }
+    else
+        cs.Tail.append(reinterpret_cast<const char*>(data), length);
+}
+
+void StringsConsumer::finishChunk(int chunk, integer_t offset, const uchar *data, integer_t)
+{
+    ChunkState& cs = this->_chunks[chunk];
+
+    if(!cs.Synced)
+        return;
+
+    cs.Scanner.flush(cs.Matches); /* UTF-16 runs ending right at the last sync point are still open */
+    sortMatches(cs.Matches.begin(), cs.Matches.end());
+
+    /* Matches are copied out while the chunk is still readable, later ones are found again in the next seam */
+    StringsConsumer::collectStrings(cs.Matches, cs.TailOffset, offset, data, cs.Strings);
+    cs.Matches = StringScanner::MatchList();
+}
+
+void StringsConsumer::completeChunks(int count)
+{
+    QVector<StringArena> strings;
+
+    /*
+     * Bytes between the last sync point of a chunk and the first one of the next are scanned here.
+     * Seams and chunks don't overlap: publishing them in file order keeps the whole list sorted.
+     */
+    for(; this->_completedchunks < count; this->_completedchunks++)
+    {
+        ChunkState& cs = this->_chunks[this->_completedchunks];
+        this->_seam.append(cs.Head);
+
+        if(!cs.Synced)
+        {
+            cs = ChunkState();
+
+            if(this->_seam.size() >= StringsConsumer::MAX_SEAM_SIZE) /* No sync point for a long time: end the run here instead of buffering the file */
+            {
+                strings.append(this->scanSeam(this->_seam, this->_seamoffset));
+                this->_seamoffset += this->_seam.size();
+                this->_seam.clear();
+            }
+
+            continue;
+        }
+
+        strings.append(this->scanSeam(this->_seam, this->_seamoffset));
+        strings.append(std::move(cs.Strings));
+
+        this->_seam = cs.Tail;
+        this->_seamoffset = cs.TailOffset;
+        cs = ChunkState();
+    }
+
+    this->publish(strings);
+}
+
+void StringsConsumer::end()
+{
+    QVector<StringArena> strings;
+
+    this->completeChunks(this->_chunks.size());
+    strings.append(this->scanSeam(this->_seam, this->_seamoffset));
+    this->publish(strings);
+
+    this->_chunks.clear();
+    this->_seam.clear();
+}
+
+StringArena StringsConsumer::scanSeam(const QByteArray &seam, integer_t offset) const
+{
+    StringScanner scanner(this->_encodings, this->_minlength);
+    StringScanner::MatchList matches;
+    StringArena strings;
+
+    scanner.reset(offset);
+    scanner.scan(reinterpret_cast<const uchar*>(seam.constData()), seam.size(), matches);
+    scanner.flush(matches);
+
+    sortMatches(matches.begin(), matches.end());
+    StringsConsumer::collectStrings(matches, offset + seam.size(), offset, reinterpret_cast<const uchar*>(seam.constData()), strings);
+    return strings;
+}
+
+void StringsConsumer::publish(QVector<StringArena> &strings)
+{
+    bool available = false;
+
+    {
+        QMutexLocker locker(&this->_mutex);
+
+        for(int i = 0; i < strings.size(); i++)
+        {
+            if(strings[i].isEmpty())
+                continue;
+
+            this->_pendingstrings.append(std::move(strings[i]));
+            available = true;
+        }
+    }
+
+    if(available)
+        emit stringsAvailable();
+}
+
+void StringsConsumer::collectStrings(const StringScanner::MatchList &matches, integer_t end, integer_t offset, const uchar *data, StringArena &strings)
+{
+    int count = 0, textlength = 0;
+
+    foreach(const StringScanner::Match& m, matches)
+    {
+        if(m.Start >= end)
+            continue;
+
+        textlength += static_cast<int>(m.End - m.Start);
+        count++;
+    }
+
+    strings.reserve(count, textlength);
+
+    foreach(const StringScanner::Match& m, matches)
+    {
+        if(m.Start < end)
+            strings.append(m, data + (m.Start - offset));
+    }
+
+    strings.buildIndex(); /* Still on a pool thread: the filter never indexes on the GUI side */
+}
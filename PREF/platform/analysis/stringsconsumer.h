@@ -0,0 +1,69 @@
+#ifndef STRINGSCONSUMER_H
+#define STRINGSCONSUMER_H
+
+#include <QVector>
+#include <QMutex>
+#include <QByteArray>
+#include "analysisconsumer.h"
+#include "stringscanner.h"
+#include "stringarena.h"
+
+class StringsConsumer : public AnalysisConsumer
+{
+    Q_OBJECT
+
+    private:
+        struct ChunkState
+        {
+            StringScanner Scanner;
+            StringScanner::MatchList Matches;
+            StringArena Strings;     /* Matches before the tail, filled by finishChunk() */
+            QByteArray Head;         /* Up to the first sync point */
+            QByteArray Tail;         /* From the last sync point */
+            integer_t TailOffset;
+            bool Synced;
+            bool PreviousZero;
+        };
+
+    public:
+        explicit StringsConsumer(QObject *parent = 0);
+        QVector<StringArena> takeStrings(int* pass);
+        int encodings() const;
+        integer_t minimumLength() const;
+        void setEncodings(int encodings);
+        void setMinimumLength(integer_t minlength);
+
+    public:
+        virtual bool isParallel() const;
+        virtual void begin(integer_t size);
+        virtual void prepareChunks(int count);
+        virtual void consumeChunk(int chunk, integer_t offset, const uchar* data, integer_t length);
+        virtual void finishChunk(int chunk, integer_t offset, const uchar* data, integer_t length);
+        virtual void completeChunks(int count);
+        virtual void end();
+
+    private:
+        StringArena scanSeam(const QByteArray& seam, integer_t offset) const;
+        void publish(QVector<StringArena>& strings);
+        static void collectStrings(const StringScanner::MatchList& matches, integer_t end, integer_t offset, const uchar* data, StringArena& strings);
+
+    signals:
+        void stringsAvailable();
+
+    private:
+        static const integer_t MIN_LENGTH;
+        static const int MAX_SEAM_SIZE;
+        QVector<ChunkState> _chunks;
+        QVector<StringArena> _pendingstrings; /* Sorted batches, waiting for takeStrings() */
+        mutable QMutex _mutex;
+        QByteArray _seam;
+        integer_t _seamoffset;
+        int _completedchunks;
+        int _pass;                            /* Bumped by begin(): strings of an older pass are stale */
+        int _encodings;                       /* Used by the running pass */
+        integer_t _minlength;
+        int _nextencodings;                   /* Applied when the next pass begins */
+        integer_t _nextminlength;
+};
+
+#endif // STRINGSCONSUMER_H
@@ -0,0 +1,145 @@
+#include "windowconsumer.h"
+#include "bytecounter.h"
+#include <QMap>
+#include <cstring>
+#include <cmath>
+
+WindowConsumer::WindowConsumer(QObject *parent) : AnalysisConsumer(parent), _windowsize(0), _size(0)
+{
+
+}
+
+integer_t WindowConsumer::windowSize() const
+{
+    return this->_windowsize;
+}
+
+integer_t WindowConsumer::windowCount() const
+{
+    if(!this->_windowsize)
+        return 0;
+
+    return (this->_size + this->_windowsize - 1) / this->_windowsize;
+}
+
+double WindowConsumer::entropy(const uint64_t *counts, integer_t size)
+{
+    if(!size)
+        return 0.0;
+
+    double e = 0.0;
+
+    for(int i = 0; i < 256; i++)
+    {
+        if(!counts[i])
+            continue;
+
+        double p = static_cast<double>(counts[i]) / static_cast<double>(size);
+        e -= p * std::log2(p);
+    }
+
+    return e / 8.0; /* Normalize to [0, 1] */
+}
+
+bool WindowConsumer::isParallel() const
+{
+    return true;
+}
+
+void WindowConsumer::begin(integer_t size)
+{
+    AnalysisConsumer::begin(size);
+
+    this->_size = size;
+    this->_windowsize = this->calculateWindowSize(size);
+}
+
+void WindowConsumer::prepareChunks(int count)
+{
+    this->_chunks.clear();
+    this->_chunks.resize(count);
+
+    for(int i = 0; i < count; i++)
+        this->_chunks[i].Open = false;
+}
+
+void WindowConsumer::consumeChunk(int chunk, integer_t offset, const uchar *data, integer_t length)
+{
+    ChunkState& cs = this->_chunks[chunk];
+
+    while(length)
+    {
+        integer_t index = offset / this->_windowsize;
+        integer_t windowstart = index * this->_windowsize;
+        integer_t windowend = windowstart + this->windowLength(index);
+        integer_t len = qMin(length, windowend - offset);
+
+        if(!cs.Open || (cs.Current.Index != index))
+        {
+            if(cs.Open)
+                cs.Partials.append(cs.Current);
+
+            cs.Open = true;
+            cs.Current.Index = index;
+            cs.Current.Size = 0;
+            std::memset(cs.Current.Counts, 0, sizeof(cs.Current.Counts));
+        }
+
+        ByteCounter::count(cs.Current.Counts, data, len);
+
+        cs.Current.Size += len;
+        offset += len;
+        data += len;
+        length -= len;
+
+        if(cs.Current.Size == this->windowLength(index)) /* Window fully inside this chunk */
+        {
+            this->window(index, windowstart, cs.Current.Counts, cs.Current.Size);
+            cs.Open = false;
+        }
+        else if(offset == windowend) /* Window started in a previous chunk */
+        {
+            cs.Partials.append(cs.Current);
+            cs.Open = false;
+        }
+    }
+}
+
+void WindowConsumer::end()
+{
+    QMap<integer_t, WindowCounts> windows;
+
+    for(int i = 0; i < this->_chunks.size(); i++)
+    {
+        ChunkState& cs = this->_chunks[i];
+
+        if(cs.Open)
+            cs.Partials.append(cs.Current);
+
+        foreach(const WindowCounts& wc, cs.Partials)
+        {
+            if(!windows.contains(wc.Index))
+            {
+                windows[wc.Index] = wc;
+                continue;
+            }
+
+            WindowCounts& merged = windows[wc.Index];
+            merged.Size += wc.Size;
+
+            for(int j = 0; j < 256; j++)
+                merged.Counts[j] += wc.Counts[j];
+        }
+    }
+
+    /* Integer counts are merged before computing entropy, results match a serial pass exactly */
+    for(auto it = windows.begin(); it != windows.end(); it++)
+        this->window(it.key(), it.key() * this->_windowsize, it.value().Counts, it.value().Size);
+
+    this->_chunks.clear();
+}
+
+integer_t WindowConsumer::windowLength(integer_t index) const
+{
+    return qMin(this->_windowsize, this->_size - (index * this->_windowsize));
+}
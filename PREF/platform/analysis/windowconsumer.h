@@ -0,0 +1,53 @@
+#ifndef WINDOWCONSUMER_H
+#define WINDOWCONSUMER_H
+
+#include <QVector>
+#include <cstdint>
+#include "analysisconsumer.h"
+
+class WindowConsumer : public AnalysisConsumer
+{
+    Q_OBJECT
+
+    private:
+        struct WindowCounts
+        {
+            integer_t Index;
+            integer_t Size;
+            uint64_t Counts[256];
+        };
+
+        struct ChunkState
+        {
+            bool Open;
+            WindowCounts Current;
+            QVector<WindowCounts> Partials; /* Windows cut by chunk boundaries */
+        };
+
+    public:
+        explicit WindowConsumer(QObject *parent = 0);
+        integer_t windowSize() const;
+        integer_t windowCount() const;
+        static double entropy(const uint64_t* counts, integer_t size);
+
+    public:
+        virtual bool isParallel() const;
+        virtual void begin(integer_t size);
+        virtual void prepareChunks(int count);
+        virtual void consumeChunk(int chunk, integer_t offset, const uchar* data, integer_t length);
+        virtual void end();
+
+    protected:
+        virtual integer_t calculateWindowSize(integer_t size) const = 0;
+        virtual void window(integer_t index, integer_t offset, const uint64_t* counts, integer_t size) = 0;
+
+    private:
+        integer_t windowLength(integer_t index) const;
+
+    private:
+        QVector<ChunkState> _chunks;
+        integer_t _windowsize;
+        integer_t _size;
+};
+
+#endif // WINDOWCONSUMER_H
@@ -0,0 +1,71 @@
+#include "arrayview.h"
+#include "datadecoder.h"
+#include <QtEndian>
+
+const int ArrayView::PAGE_SIZE = 0x400; /* Elements */
+
+ArrayView::ArrayView(): _lazyarray(NULL), _page(-1), _type(-1)
+{
+
+}
+
+void ArrayView::clear()
+{
+    this->_lazyarray = NULL;
+    this->_page = -1;
+    this->_data.clear();
+}
+
+QString ArrayView::value(const TemplateResult::LazyArray *lazyarray, int index, QHexDocument *document)
+{
+    int page = index / ArrayView::PAGE_SIZE;
+
+    if((lazyarray != this->_lazyarray) || (page != this->_page))
+        this->load(lazyarray, page, document);
+
+    int pos = (index % ArrayView::PAGE_SIZE) * static_cast<int>(lazyarray->Stride);
+
+    if((pos + lazyarray->Stride) > static_cast<integer_t>(this->_data.size())) /* Past the end of the file */
+        return QString();
+
+    return DataDecoder::decode(this->_type, reinterpret_cast<const uchar*>(this->_data.constData()) + pos, lazyarray->Stride);
+}
+
+void ArrayView::load(const TemplateResult::LazyArray *lazyarray, int page, QHexDocument *document)
+{
+    int first = page * ArrayView::PAGE_SIZE;
+    int count = qMin(ArrayView::PAGE_SIZE, lazyarray->Count - first);
+
+    this->_lazyarray = lazyarray;
+    this->_page = page;
+    this->_type = DataDecoder::littleEndianType(lazyarray->Type);
+    this->_data = document->read(lazyarray->Base + (first * lazyarray->Stride), count * lazyarray->Stride); /* One read for the whole page */
+
+    if(DataDecoder::isBigEndian(lazyarray->Type))
+        ArrayView::toLittleEndian(lazyarray->Type, reinterpret_cast<uchar*>(this->_data.data()), this->_data.size() / static_cast<int>(lazyarray->Stride));
+}
+
+void ArrayView::toLittleEndian(int type, uchar *data, int count)
+{
+    /* Qt's array overloads swap in place with SIMD where available; the second pass is a no-op on little endian hosts */
+    switch(DataDecoder::size(type))
+    {
+        case 2:
+            qFromBigEndian<quint16>(data, count, data);
+            qToLittleEndian<quint16>(data, count, data);
+            break;
+
+        case 4:
+            qFromBigEndian<quint32>(data, count, data);
+            qToLittleEndian<quint32>(data, count, data);
+            break;
+
+        case 8:
+            qFromBigEndian<quint64>(data, count, data);
+            qToLittleEndian<quint64>(data, count, data);
+            break;
+
+        default:
+            break;
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef ARRAYVIEW_H
+#define ARRAYVIEW_H
+
+#include <QByteArray>
+#include "templateresult.h"
+
+class ArrayView /* Typed window over a lazy array: elements are read and byte swapped a page at a time */
+{
+    public:
+        ArrayView();
+        void clear();
+        QString value(const TemplateResult::LazyArray* lazyarray, int index, QHexDocument* document);
+
+    private:
+        void load(const TemplateResult::LazyArray* lazyarray, int page, QHexDocument* document);
+        static void toLittleEndian(int type, uchar* data, int count);
+
+    private:
+        static const int PAGE_SIZE;
+        const TemplateResult::LazyArray* _lazyarray;
+        int _page;
+        int _type;         /* Little endian counterpart of the array's type */
+        QByteArray _data;  /* Little endian elements */
+};
+
+#endif // ARRAYVIEW_H
@@ -12,7 +12,7 @@ class BasicWorker : public QThread
         explicit BasicWorker(QHexDocument *document, QObject *parent = 0);
 
     public slots:
-        void abort();
+        virtual void abort();
 
     protected:
         QHexDocument* _document;
@@ -1,14 +1,40 @@
 #include "btvmex.h"
-#include <QColor>
 
-BTVMEX::BTVMEX(QHexDocument *document, LogWidget *logwidget, BTVMIO *btvmio): BTVM(btvmio), _document(document), _logwidget(logwidget)
+const int BTVMEX::PROGRESS_INTERVAL = 0x100; /* Entries */
+
+BTVMEX::BTVMEX(BTVMIO *btvmio, QObject *parent): QObject(parent), BTVM(btvmio), _exporter(NULL), _profiler(NULL), _aborted(0), _covered(0), _entries(0)
+{
+
+}
+
+void BTVMEX::abort()
+{
+    this->_aborted.store(1);
+}
+
+bool BTVMEX::isAborted() const
 {
+    return this->_aborted.load() != 0;
+}
 
+void BTVMEX::buildHighlights()
+{
+    this->_highlights.build();
 }
 
-BTVMEX::BTVMEX(QHexDocument *document, BTVMIO *btvmio): BTVM(btvmio), _document(document), _logwidget(NULL)
+const HighlightTable &BTVMEX::highlights() const
 {
+    return this->_highlights;
+}
+
+void BTVMEX::setExporter(TemplateExporter *exporter)
+{
+    this->_exporter = exporter;
+}
 
+void BTVMEX::setProfiler(TemplateProfiler *profiler)
+{
+    this->_profiler = profiler;
 }
 
 QRgb BTVMEX::bgrToRgb(uint32_t bgr) const
@@ -16,30 +42,50 @@ QRgb BTVMEX::bgrToRgb(uint32_t bgr) const
     return (bgr & 0X000000FF) << 16 | (bgr & 0x0000FF00) | (bgr & 0x00FF0000) >> 16;
 }
 
+void BTVMEX::checkAborted() const
+{
+    if(this->isAborted())
+        throw Aborted();
+}
+
 void BTVMEX::entryCreated(const BTEntryPtr &btentry)
 {
-    QRgb rgb = 0;
+    this->checkAborted();
+
+    if(this->_profiler) /* The VM's time up to this entry */
+        this->_profiler->entryCreated(btentry);
+
+    this->_covered = qMax(this->_covered, static_cast<integer_t>(btentry->location.end()));
+    this->_entries++;
+
+    if(!(this->_entries % BTVMEX::PROGRESS_INTERVAL))
+        emit progressChanged(this->_covered, this->_entries);
+
+    if(this->_exporter && !this->_exporter->append(btentry)) /* Nothing more can be written */
+        this->abort();
+
+    QRgb fore = 0, back = 0;
+    QString comment;
 
     if(btentry->value->value_fgcolor != ColorInvalid)
     {
-        rgb = this->bgrToRgb(btentry->value->value_fgcolor);
-        this->_document->highlightFore(btentry->location.offset, btentry->location.end(), QColor::fromRgb(rgb));
+        fore = QColor::fromRgb(this->bgrToRgb(btentry->value->value_fgcolor)).rgb();
 
         if(btentry->value->is_readable() && !btentry->value->value_id.empty())
-            this->_document->comment(btentry->location.offset, btentry->location.end(), QString::fromStdString(btentry->value->value_id));
+            comment = QString::fromStdString(btentry->value->value_id);
     }
 
     if(btentry->value->value_bgcolor != ColorInvalid)
-    {
-        rgb = this->bgrToRgb(btentry->value->value_bgcolor);
-        this->_document->highlightBack(btentry->location.offset, btentry->location.end(), QColor::fromRgb(rgb));
-    }
+        back = QColor::fromRgb(this->bgrToRgb(btentry->value->value_bgcolor)).rgb();
+
+    this->_highlights.insert(btentry->location.offset, btentry->location.end(), fore, back, comment);
+
+    if(this->_profiler) /* Bookkeeping above isn't charged to the next entry */
+        this->_profiler->resume();
 }
 
 void BTVMEX::print(const std::string &s)
 {
-    if(!this->_logwidget)
-        return;
-
-    this->_logwidget->log(QString::fromStdString(s));
+    this->checkAborted();
+    emit printed(QString::fromStdString(s));
 }
@@ -1,26 +1,50 @@
 #ifndef BTVMEX_H
 #define BTVMEX_H
 
+#include <QObject>
+#include <QAtomicInt>
 #include <qhexedit/document/qhexdocument.h>
 #include <bt/btvm/btvm.h>
-#include "../widgets/logwidget/logwidget.h"
+#include "highlighttable.h"
+#include "templateexporter.h"
+#include "templateprofiler.h"
 
-class BTVMEX: public BTVM
+class BTVMEX: public QObject, public BTVM
 {
+    Q_OBJECT
+
+    public:
+        class Aborted { }; /* Thrown from the VM callbacks to unwind a cancelled execution */
+
     public:
-        BTVMEX(QHexDocument* document, LogWidget* logwidget, BTVMIO* btvmio);
-        BTVMEX(QHexDocument* document, BTVMIO* btvmio);
+        BTVMEX(BTVMIO* btvmio, QObject* parent = 0);
+        void abort();
+        bool isAborted() const;
+        void buildHighlights();
+        const HighlightTable& highlights() const;
+        void setExporter(TemplateExporter* exporter);
+        void setProfiler(TemplateProfiler* profiler);
 
     private:
         QRgb bgrToRgb(uint32_t bgr) const;
+        void checkAborted() const;
 
     protected:
         virtual void entryCreated(const BTEntryPtr &btentry);
         virtual void print(const std::string& s);
 
+    signals:
+        void printed(const QString& s);
+        void progressChanged(integer_t covered, int entries);
+
     private:
-        QHexDocument* _document;
-        LogWidget* _logwidget;
+        static const int PROGRESS_INTERVAL;
+        TemplateExporter* _exporter; /* Entries are written as soon as they are created */
+        TemplateProfiler* _profiler;
+        HighlightTable _highlights; /* The document belongs to the GUI thread: applied once the template is ready */
+        QAtomicInt _aborted;
+        integer_t _covered;
+        int _entries;
 };
 
 #endif // BTVMEX_H
@@ -0,0 +1,265 @@
+#include "datadecoder.h"
+#include <QObject>
+#include <QDateTime>
+#include <QtEndian>
+#include <cstring>
+#include <limits>
+
+struct TypeInfo
+{
+    const char* Name;
+    integer_t Size;
+    DataDecoder::Category Category;
+};
+
+static const TypeInfo TYPES[DataDecoder::TypeCount] = { { "int8",          1,  DataDecoder::Integer },
+                                                        { "uint8",         1,  DataDecoder::Integer },
+                                                        { "int16 (LE)",    2,  DataDecoder::Integer },
+                                                        { "int16 (BE)",    2,  DataDecoder::Integer },
+                                                        { "uint16 (LE)",   2,  DataDecoder::Integer },
+                                                        { "uint16 (BE)",   2,  DataDecoder::Integer },
+                                                        { "int32 (LE)",    4,  DataDecoder::Integer },
+                                                        { "int32 (BE)",    4,  DataDecoder::Integer },
+                                                        { "uint32 (LE)",   4,  DataDecoder::Integer },
+                                                        { "uint32 (BE)",   4,  DataDecoder::Integer },
+                                                        { "int64 (LE)",    8,  DataDecoder::Integer },
+                                                        { "int64 (BE)",    8,  DataDecoder::Integer },
+                                                        { "uint64 (LE)",   8,  DataDecoder::Integer },
+                                                        { "uint64 (BE)",   8,  DataDecoder::Integer },
+                                                        { "float (LE)",    4,  DataDecoder::FloatingPoint },
+                                                        { "float (BE)",    4,  DataDecoder::FloatingPoint },
+                                                        { "double (LE)",   8,  DataDecoder::FloatingPoint },
+                                                        { "double (BE)",   8,  DataDecoder::FloatingPoint },
+                                                        { "char",          1,  DataDecoder::Text },
+                                                        { "wchar_t",       2,  DataDecoder::Text },
+                                                        { "binary",        1,  DataDecoder::Other },
+                                                        { "time_t",        4,  DataDecoder::Other },
+                                                        { "time64_t",      8,  DataDecoder::Other },
+                                                        { "FILETIME",      8,  DataDecoder::Other },
+                                                        { "DOSDATE",       2,  DataDecoder::Other },
+                                                        { "DOSTIME",       2,  DataDecoder::Other },
+                                                        { "GUID",          16, DataDecoder::Other } };
+
+const integer_t DataDecoder::WINDOW_SIZE = 16; /* Largest type */
+
+static QString unsignedValue(quint64 value)
+{
+    return QString::number(value, 16).toUpper() + "h";
+}
+
+static QString signedValue(qint64 value)
+{
+    if(value >= 0)
+        return unsignedValue(static_cast<quint64>(value));
+
+    return "-" + unsignedValue(0 - static_cast<quint64>(value));
+}
+
+static QString floatValue(quint32 bits)
+{
+    float f = 0;
+    std::memcpy(&f, &bits, sizeof(float));
+    return QString::number(f, 'g', 9);
+}
+
+static QString doubleValue(quint64 bits)
+{
+    double d = 0;
+    std::memcpy(&d, &bits, sizeof(double));
+    return QString::number(d, 'g', 17);
+}
+
+static QString dateTimeValue(qint64 secs)
+{
+    if((secs > std::numeric_limits<qint64>::max() / 1000) || (secs < std::numeric_limits<qint64>::min() / 1000))
+        return QObject::tr("Invalid");
+
+    QDateTime datetime = QDateTime::fromMSecsSinceEpoch(secs * 1000, Qt::UTC);
+
+    if(!datetime.isValid())
+        return QObject::tr("Invalid");
+
+    return datetime.toString("yyyy-MM-dd hh:mm:ss");
+}
+
+QString DataDecoder::typeName(int type)
+{
+    return QString::fromLatin1(TYPES[type].Name);
+}
+
+integer_t DataDecoder::size(int type)
+{
+    return TYPES[type].Size;
+}
+
+DataDecoder::Category DataDecoder::category(int type)
+{
+    return TYPES[type].Category;
+}
+
+QColor DataDecoder::categoryColor(DataDecoder::Category category)
+{
+    if(category == DataDecoder::Integer)
+        return QColor(Qt::darkBlue);
+    else if(category == DataDecoder::FloatingPoint)
+        return QColor(Qt::darkRed);
+    else if(category == DataDecoder::Text)
+        return QColor(Qt::darkGreen);
+
+    return QColor(Qt::black);
+}
+
+bool DataDecoder::isBigEndian(int type)
+{
+    return DataDecoder::littleEndianType(type) != type;
+}
+
+int DataDecoder::littleEndianType(int type)
+{
+    switch(type)
+    {
+        case DataDecoder::Int16BE:  return DataDecoder::Int16LE;
+        case DataDecoder::UInt16BE: return DataDecoder::UInt16LE;
+        case DataDecoder::Int32BE:  return DataDecoder::Int32LE;
+        case DataDecoder::UInt32BE: return DataDecoder::UInt32LE;
+        case DataDecoder::Int64BE:  return DataDecoder::Int64LE;
+        case DataDecoder::UInt64BE: return DataDecoder::UInt64LE;
+        case DataDecoder::FloatBE:  return DataDecoder::FloatLE;
+        case DataDecoder::DoubleBE: return DataDecoder::DoubleLE;
+        default: break;
+    }
+
+    return type;
+}
+
+QString DataDecoder::decode(int type, const uchar *data, integer_t length)
+{
+    if(length < TYPES[type].Size) /* Past the end of the file */
+        return QString();
+
+    switch(type)
+    {
+        case DataDecoder::Int8:     return signedValue(static_cast<qint8>(data[0]));
+        case DataDecoder::UInt8:    return unsignedValue(data[0]);
+        case DataDecoder::Int16LE:  return signedValue(qFromLittleEndian<qint16>(data));
+        case DataDecoder::Int16BE:  return signedValue(qFromBigEndian<qint16>(data));
+        case DataDecoder::UInt16LE: return unsignedValue(qFromLittleEndian<quint16>(data));
+        case DataDecoder::UInt16BE: return unsignedValue(qFromBigEndian<quint16>(data));
+        case DataDecoder::Int32LE:  return signedValue(qFromLittleEndian<qint32>(data));
+        case DataDecoder::Int32BE:  return signedValue(qFromBigEndian<qint32>(data));
+        case DataDecoder::UInt32LE: return unsignedValue(qFromLittleEndian<quint32>(data));
+        case DataDecoder::UInt32BE: return unsignedValue(qFromBigEndian<quint32>(data));
+        case DataDecoder::Int64LE:  return signedValue(qFromLittleEndian<qint64>(data));
+        case DataDecoder::Int64BE:  return signedValue(qFromBigEndian<qint64>(data));
+        case DataDecoder::UInt64LE: return unsignedValue(qFromLittleEndian<quint64>(data));
+        case DataDecoder::UInt64BE: return unsignedValue(qFromBigEndian<quint64>(data));
+        case DataDecoder::FloatLE:  return floatValue(qFromLittleEndian<quint32>(data));
+        case DataDecoder::FloatBE:  return floatValue(qFromBigEndian<quint32>(data));
+        case DataDecoder::DoubleLE: return doubleValue(qFromLittleEndian<quint64>(data));
+        case DataDecoder::DoubleBE: return doubleValue(qFromBigEndian<quint64>(data));
+        case DataDecoder::Binary:   return QString::number(data[0], 2).rightJustified(8, '0');
+        case DataDecoder::Time32:   return dateTimeValue(qFromLittleEndian<qint32>(data)); /* Signed: dates before 1970 */
+        case DataDecoder::Time64:   return dateTimeValue(qFromLittleEndian<qint64>(data));
+        default: break;
+    }
+
+    if(type == DataDecoder::Char)
+    {
+        if((data[0] < 0x20) || (data[0] > 0x7E))
+            return QString(".");
+
+        return QString(QChar(data[0]));
+    }
+
+    if(type == DataDecoder::WideChar)
+    {
+        QChar ch(qFromLittleEndian<quint16>(data));
+
+        if(!ch.isPrint() || ch.isSurrogate())
+            return QString(".");
+
+        return QString(ch);
+    }
+
+    if(type == DataDecoder::FileTime) /* 100ns intervals since 1601-01-01 */
+    {
+        quint64 filetime = qFromLittleEndian<quint64>(data);
+        return dateTimeValue(static_cast<qint64>(filetime / 10000000) - Q_INT64_C(11644473600));
+    }
+
+    if(type == DataDecoder::DosDate)
+    {
+        quint16 dosdate = qFromLittleEndian<quint16>(data);
+        QDate date(1980 + (dosdate >> 9), (dosdate >> 5) & 0x0F, dosdate & 0x1F);
+        return date.isValid() ? date.toString("yyyy-MM-dd") : QObject::tr("Invalid");
+    }
+
+    if(type == DataDecoder::DosTime)
+    {
+        quint16 dostime = qFromLittleEndian<quint16>(data);
+        QTime time(dostime >> 11, (dostime >> 5) & 0x3F, (dostime & 0x1F) * 2);
+        return time.isValid() ? time.toString("hh:mm:ss") : QObject::tr("Invalid");
+    }
+
+    if(type == DataDecoder::Guid)
+    {
+        QString guid = QString("{%1-%2-%3-").arg(qFromLittleEndian<quint32>(data), 8, 16, QChar('0'))
+                                            .arg(qFromLittleEndian<quint16>(data + 4), 4, 16, QChar('0'))
+                                            .arg(qFromLittleEndian<quint16>(data + 6), 4, 16, QChar('0'));
+
+        for(int i = 8; i < 16; i++)
+        {
+            if(i == 10)
+                guid += "-";
+
+            guid += QString("%1").arg(data[i], 2, 16, QChar('0'));
+        }
+
+        return (guid + "}").toUpper();
+    }
+
+    return QString();
+}
+
+QVariant DataDecoder::decodeNumber(int type, const uchar *data, integer_t length)
+{
+    if(length < TYPES[type].Size)
+        return QVariant();
+
+    switch(type)
+    {
+        case DataDecoder::Int8:     return static_cast<qlonglong>(static_cast<qint8>(data[0]));
+        case DataDecoder::UInt8:    return static_cast<qulonglong>(data[0]);
+        case DataDecoder::Int16LE:  return static_cast<qlonglong>(qFromLittleEndian<qint16>(data));
+        case DataDecoder::Int16BE:  return static_cast<qlonglong>(qFromBigEndian<qint16>(data));
+        case DataDecoder::UInt16LE: return static_cast<qulonglong>(qFromLittleEndian<quint16>(data));
+        case DataDecoder::UInt16BE: return static_cast<qulonglong>(qFromBigEndian<quint16>(data));
+        case DataDecoder::Int32LE:  return static_cast<qlonglong>(qFromLittleEndian<qint32>(data));
+        case DataDecoder::Int32BE:  return static_cast<qlonglong>(qFromBigEndian<qint32>(data));
+        case DataDecoder::UInt32LE: return static_cast<qulonglong>(qFromLittleEndian<quint32>(data));
+        case DataDecoder::UInt32BE: return static_cast<qulonglong>(qFromBigEndian<quint32>(data));
+        case DataDecoder::Int64LE:  return static_cast<qlonglong>(qFromLittleEndian<qint64>(data));
+        case DataDecoder::Int64BE:  return static_cast<qlonglong>(qFromBigEndian<qint64>(data));
+        case DataDecoder::UInt64LE: return static_cast<qulonglong>(qFromLittleEndian<quint64>(data));
+        case DataDecoder::UInt64BE: return static_cast<qulonglong>(qFromBigEndian<quint64>(data));
+        default: break;
+    }
+
+    if((type == DataDecoder::FloatLE) || (type == DataDecoder::FloatBE))
+    {
+        quint32 bits = (type == DataDecoder::FloatLE) ? qFromLittleEndian<quint32>(data) : qFromBigEndian<quint32>(data);
+        float f = 0;
+        std::memcpy(&f, &bits, sizeof(float));
+        return static_cast<double>(f);
+    }
+
+    if((type == DataDecoder::DoubleLE) || (type == DataDecoder::DoubleBE))
+    {
+        quint64 bits = (type == DataDecoder::DoubleLE) ? qFromLittleEndian<quint64>(data) : qFromBigEndian<quint64>(data);
+        double d = 0;
+        std::memcpy(&d, &bits, sizeof(double));
+        return d;
+    }
+
+    return QVariant();
+}
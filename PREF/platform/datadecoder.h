@@ -0,0 +1,39 @@
+#ifndef DATADECODER_H
+#define DATADECODER_H
+
+#include <QString>
+#include <QColor>
+#include <QVariant>
+#include <qhexedit/document/qhexdocument.h>
+
+class DataDecoder
+{
+    public:
+        enum Category { Integer, FloatingPoint, Text, Other };
+
+        enum Type
+        {
+            Int8, UInt8,
+            Int16LE, Int16BE, UInt16LE, UInt16BE,
+            Int32LE, Int32BE, UInt32LE, UInt32BE,
+            Int64LE, Int64BE, UInt64LE, UInt64BE,
+            FloatLE, FloatBE, DoubleLE, DoubleBE,
+            Char, WideChar, Binary,
+            Time32, Time64, FileTime, DosDate, DosTime,
+            Guid,
+            TypeCount
+        };
+
+    public:
+        static const integer_t WINDOW_SIZE;
+        static QString typeName(int type);
+        static integer_t size(int type);
+        static Category category(int type);
+        static QColor categoryColor(Category category);
+        static bool isBigEndian(int type);
+        static int littleEndianType(int type);
+        static QString decode(int type, const uchar* data, integer_t length);
+        static QVariant decodeNumber(int type, const uchar* data, integer_t length);
+};
+
+#endif // DATADECODER_H
@@ -0,0 +1,124 @@
+#include "highlighttable.h"
+#include <algorithm>
+#include <set>
+
+HighlightTable::HighlightTable()
+{
+
+}
+
+bool HighlightTable::isEmpty() const
+{
+    return this->_runs.isEmpty() && this->_pending.isEmpty();
+}
+
+void HighlightTable::insert(integer_t start, integer_t end, QRgb fore, QRgb back, const QString &comment)
+{
+    if((start >= end) || (!fore && !back && comment.isEmpty()))
+        return;
+
+    Run run;
+    run.Start = start;
+    run.End = end;
+    run.Fore = fore;
+    run.Back = back;
+    run.Comment = comment;
+
+    this->_pending.append(run);
+}
+
+void HighlightTable::build()
+{
+    QVector<Boundary> boundaries;
+    boundaries.reserve(this->_pending.size() * 2);
+
+    for(int i = 0; i < this->_pending.size(); i++)
+    {
+        Boundary open = { this->_pending[i].Start, i, true };
+        Boundary close = { this->_pending[i].End, i, false };
+
+        boundaries.append(open);
+        boundaries.append(close);
+    }
+
+    std::sort(boundaries.begin(), boundaries.end(), [](const Boundary& b1, const Boundary& b2) { return b1.Offset < b2.Offset; });
+
+    /* Sweep the boundaries: the most recent entry covering a range wins, separately for every attribute */
+    std::set<int> fore, back, comment;
+    this->_runs.clear();
+
+    for(int i = 0; i < boundaries.size(); )
+    {
+        integer_t offset = boundaries[i].Offset;
+
+        for(; (i < boundaries.size()) && (boundaries[i].Offset == offset); i++)
+        {
+            const Boundary& boundary = boundaries[i];
+            const Run& pending = this->_pending[boundary.Index];
+
+            if(boundary.Open)
+            {
+                if(pending.Fore)
+                    fore.insert(boundary.Index);
+
+                if(pending.Back)
+                    back.insert(boundary.Index);
+
+                if(!pending.Comment.isEmpty())
+                    comment.insert(boundary.Index);
+            }
+            else
+            {
+                fore.erase(boundary.Index);
+                back.erase(boundary.Index);
+                comment.erase(boundary.Index);
+            }
+        }
+
+        if((i >= boundaries.size()) || (fore.empty() && back.empty() && comment.empty()))
+            continue;
+
+        Run run;
+        run.Start = offset;
+        run.End = boundaries[i].Offset;
+        run.Fore = fore.empty() ? 0 : this->_pending[*fore.rbegin()].Fore;
+        run.Back = back.empty() ? 0 : this->_pending[*back.rbegin()].Back;
+        run.Comment = comment.empty() ? QString() : this->_pending[*comment.rbegin()].Comment;
+
+        if(!this->_runs.isEmpty())
+        {
+            Run& last = this->_runs.last();
+
+            if((last.End == run.Start) && (last.Fore == run.Fore) && (last.Back == run.Back) && (last.Comment == run.Comment))
+            {
+                last.End = run.End;
+                continue;
+            }
+        }
+
+        this->_runs.append(run);
+    }
+
+    this->_pending = RunList();
+    this->_runs.squeeze();
+}
+
+const HighlightTable::RunList &HighlightTable::runs() const
+{
+    return this->_runs;
+}
+
+void HighlightTable::apply(QHexDocument *document) const
+{
+    foreach(const Run& run, this->_runs)
+    {
+        if(run.Fore)
+            document->highlightFore(run.Start, run.End, QColor::fromRgb(run.Fore));
+
+        if(run.Back)
+            document->highlightBack(run.Start, run.End, QColor::fromRgb(run.Back));
+
+        if(!run.Comment.isEmpty())
+            document->comment(run.Start, run.End, run.Comment);
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef HIGHLIGHTTABLE_H
+#define HIGHLIGHTTABLE_H
+
+#include <QVector>
+#include <QColor>
+#include <qhexedit/document/qhexdocument.h>
+
+class HighlightTable
+{
+    public:
+        struct Run
+        {
+            integer_t Start;
+            integer_t End;
+            QRgb Fore;       /* 0: no color, valid ones are opaque */
+            QRgb Back;
+            QString Comment;
+        };
+
+        typedef QVector<Run> RunList;
+
+    private:
+        struct Boundary
+        {
+            integer_t Offset;
+            int Index;
+            bool Open;
+        };
+
+    public:
+        HighlightTable();
+        bool isEmpty() const;
+        void insert(integer_t start, integer_t end, QRgb fore, QRgb back, const QString& comment);
+        void build();
+        const RunList& runs() const;
+        void apply(QHexDocument* document) const;
+
+    private:
+        RunList _pending; /* Insertion order: later entries are drawn over earlier ones */
+        RunList _runs;    /* Sorted, disjoint and merged when adjacent ones look the same */
+};
+
+#endif // HIGHLIGHTTABLE_H
@@ -3,6 +3,7 @@
 
 LoadedData::LoadedData(QHexDocument *document): DataBuffer(DataBuffer::ReadWrite), _document(document)
 {
+    this->_mappedfile = MappedFile::fromDocument(document);
 }
 
 LoadedData::~LoadedData()
@@ -16,7 +17,10 @@ uint64_t LoadedData::size() const
 
 uint64_t LoadedData::readData(uint8_t *buffer, uint64_t size)
 {
+    if(this->_mappedfile) /* Unmodified bytes are copied straight from the mapped file */
+        return this->_mappedfile->read(this->offset(), buffer, size);
+
     QByteArray ba = this->_document->read(this->offset(), size);
-    std::memcpy(buffer, ba.data(), ba.size()); //FIXME: memcpy is suboptimal
+    std::memcpy(buffer, ba.data(), ba.size());
     return ba.size();
 }
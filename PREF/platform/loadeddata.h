@@ -3,6 +3,7 @@
 
 #include <qhexedit/document/qhexdocument.h>
 #include <preflib.h>
+#include "mappedfile.h"
 
 class LoadedData: public PrefLib::IO::DataBuffer
 {
@@ -16,6 +17,7 @@ class LoadedData: public PrefLib::IO::DataBuffer
 
     private:
         QHexDocument* _document;
+        MappedFile* _mappedfile;
 };
 
 #endif // LOADEDDATA_H
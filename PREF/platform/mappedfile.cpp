@@ -0,0 +1,323 @@
+#include "mappedfile.h"
+#include <cstring>
+
+const integer_t MappedFile::SEARCH_WINDOW = 0x10000;
+const integer_t MappedFile::BLOCK_SIZE = 0x1000;
+
+MappedFile::MappedFile(QHexDocument *document, const QString &filename): QObject(document), _document(document), _file(filename), _lock(QReadWriteLock::Recursive), _dirtyfrom(0), _size(0), _data(NULL)
+{
+    connect(this->_document, &QHexDocument::documentChanged, this, &MappedFile::updateDirtyRanges);
+    this->remap();
+}
+
+MappedFile::~MappedFile()
+{
+    this->unmap();
+}
+
+MappedFile *MappedFile::fromDocument(QHexDocument *document)
+{
+    if(!document)
+        return NULL;
+
+    return document->findChild<MappedFile*>(QString(), Qt::FindDirectChildrenOnly);
+}
+
+bool MappedFile::isMapped() const
+{
+    return this->_data != NULL;
+}
+
+integer_t MappedFile::read(integer_t offset, uchar *buffer, integer_t length)
+{
+    QReadLocker locker(&this->_lock);
+    integer_t count = 0;
+
+    while(count < length)
+    {
+        bool dirty = false;
+        integer_t len = this->dirtyLength(offset + count, length - count, &dirty);
+
+        if(!dirty)
+        {
+            std::memcpy(buffer + count, this->_data + offset + count, len);
+            count += len;
+            continue;
+        }
+
+        QByteArray ba = this->_document->read(offset + count, len);
+        std::memcpy(buffer + count, ba.constData(), ba.size());
+        count += ba.size();
+
+        if(static_cast<integer_t>(ba.size()) < len)
+            break;
+    }
+
+    return count;
+}
+
+const uchar *MappedFile::acquire(integer_t offset, integer_t length)
+{
+    bool dirty = false;
+    this->_lock.lockForRead();
+
+    if((this->dirtyLength(offset, length, &dirty) == length) && !dirty)
+        return this->_data + offset; /* The mapping stays valid until release() is called */
+
+    this->_lock.unlock();
+    return NULL;
+}
+
+void MappedFile::release()
+{
+    this->_lock.unlock();
+}
+
+void MappedFile::unmap()
+{
+    QWriteLocker locker(&this->_lock);
+
+    if(this->_data)
+        this->_file.unmap(this->_data);
+
+    this->_file.close();
+    this->_dirtyranges.clear();
+    this->_dirtyfrom = 0;
+    this->_size = 0;
+    this->_data = NULL;
+}
+
+void MappedFile::remap()
+{
+    this->unmap();
+
+    QWriteLocker locker(&this->_lock);
+
+    if(!this->_file.open(QFile::ReadOnly))
+        return;
+
+    this->_size = this->_file.size();
+
+    if(this->_size == this->_document->length()) /* Mapping can fail for huge files on 32 bit builds, LoadedData falls back to QHexDocument */
+        this->_data = this->_file.map(0, this->_size);
+
+    if(!this->_data)
+    {
+        this->_file.close();
+        this->_size = 0;
+        return;
+    }
+
+    this->_dirtyfrom = this->_size;
+}
+
+void MappedFile::updateDirtyRanges()
+{
+    if(!this->_data || !this->_dirtyfrom)
+    {
+        emit dataInvalidated(); /* Nothing to compare with: listeners need a full pass */
+        return;
+    }
+
+    if(this->_document->length() != this->_size) /* Insertions and removals shift every byte after the edit: stop using the mapping */
+    {
+        this->invalidateMapping();
+        return;
+    }
+
+    /* QHexDocument doesn't report what changed, edits happen around the cursor so look there first */
+    integer_t hint = this->_document->cursor()->offset();
+    integer_t start = (hint > MappedFile::SEARCH_WINDOW) ? (hint - MappedFile::SEARCH_WINDOW) : 0;
+    integer_t end = qMin(hint + MappedFile::SEARCH_WINDOW, this->_dirtyfrom);
+    integer_t changestart = 0, changeend = 0;
+
+    start -= start % MappedFile::BLOCK_SIZE;
+
+    if(this->findChange(start, end, &changestart, &changeend))
+    {
+        this->applyChange(changestart, changeend);
+        return;
+    }
+
+    if(!this->findDirtyChange()) /* Finding it would mean reading the whole document: stop trusting the mapping instead */
+        this->invalidateMapping();
+}
+
+integer_t MappedFile::dirtyLength(integer_t offset, integer_t length, bool *dirty) const
+{
+    if(!this->_data || (offset >= this->_dirtyfrom))
+    {
+        *dirty = true;
+        return length;
+    }
+
+    integer_t cleanend = qMin(offset + length, this->_dirtyfrom);
+    auto it = this->_dirtyranges.upperBound(offset);
+
+    if(it != this->_dirtyranges.begin())
+    {
+        auto previt = it;
+        previt--;
+
+        integer_t rangeend = previt.key() + previt.value().size();
+
+        if(offset < rangeend)
+        {
+            *dirty = true;
+            return qMin(offset + length, rangeend) - offset;
+        }
+    }
+
+    if(it != this->_dirtyranges.end())
+        cleanend = qMin(cleanend, it.key());
+
+    *dirty = false;
+    return cleanend - offset;
+}
+
+QByteArray MappedFile::previousData(integer_t offset, integer_t length) const
+{
+    QByteArray ba(reinterpret_cast<const char*>(this->_data + offset), length);
+    auto it = this->_dirtyranges.upperBound(offset);
+
+    if(it != this->_dirtyranges.begin())
+        it--;
+
+    for(; (it != this->_dirtyranges.end()) && (it.key() < offset + length); it++)
+    {
+        integer_t start = qMax(offset, it.key());
+        integer_t end = qMin(offset + length, it.key() + it.value().size());
+
+        if(start >= end)
+            continue;
+
+        std::memcpy(ba.data() + (start - offset), it.value().constData() + (start - it.key()), end - start);
+    }
+
+    return ba;
+}
+
+bool MappedFile::blockChanged(integer_t offset, integer_t length) const
+{
+    if(!this->_data || (offset + length > this->_dirtyfrom))
+        return false;
+
+    QByteArray current = this->_document->read(offset, length);
+    bool dirty = false;
+
+    if((this->dirtyLength(offset, length, &dirty) == length) && !dirty) /* Clean blocks are compared with the mapping in place */
+        return (current.size() != static_cast<int>(length)) || std::memcmp(current.constData(), this->_data + offset, length);
+
+    return current != this->previousData(offset, length);
+}
+
+bool MappedFile::findChange(integer_t start, integer_t end, integer_t *changestart, integer_t *changeend) const
+{
+    bool found = false;
+
+    for(integer_t offset = start; offset < end; offset += MappedFile::BLOCK_SIZE)
+    {
+        integer_t len = qMin(MappedFile::BLOCK_SIZE, end - offset);
+
+        if(!this->blockChanged(offset, len))
+            continue;
+
+        if(!found)
+            *changestart = offset;
+
+        *changeend = offset + len;
+        found = true;
+    }
+
+    if(!found)
+        return false;
+
+    /* Edits bigger than the search window: grow the range while neighbouring blocks differ */
+    while((*changestart == start) && *changestart && this->blockChanged(*changestart - MappedFile::BLOCK_SIZE, MappedFile::BLOCK_SIZE))
+        start = *changestart -= MappedFile::BLOCK_SIZE;
+
+    while((*changeend == end) && (*changeend < this->_dirtyfrom))
+    {
+        integer_t len = qMin(MappedFile::BLOCK_SIZE, this->_dirtyfrom - *changeend);
+
+        if(!this->blockChanged(*changeend, len))
+            break;
+
+        end = *changeend += len;
+    }
+
+    return true;
+}
+
+bool MappedFile::findDirtyChange()
+{
+    /* Undo and redo only touch bytes that were already edited once */
+    QList< QPair<integer_t, integer_t> > ranges;
+    bool found = false;
+
+    for(auto it = this->_dirtyranges.begin(); it != this->_dirtyranges.end(); it++)
+        ranges.append(qMakePair(it.key() - (it.key() % MappedFile::BLOCK_SIZE), qMin(it.key() + it.value().size(), this->_dirtyfrom)));
+
+    for(int i = 0; i < ranges.size(); i++)
+    {
+        integer_t changestart = 0, changeend = 0;
+
+        if(!this->findChange(ranges[i].first, ranges[i].second, &changestart, &changeend))
+            continue;
+
+        this->applyChange(changestart, changeend);
+        found = true;
+    }
+
+    return found;
+}
+
+void MappedFile::invalidateMapping()
+{
+    {
+        QWriteLocker locker(&this->_lock);
+        this->_dirtyranges.clear();
+        this->_dirtyfrom = 0;
+    }
+
+    emit dataInvalidated(); /* Listeners need a full pass, reads go through QHexDocument from now on */
+}
+
+void MappedFile::applyChange(integer_t start, integer_t end)
+{
+    if(!this->_data || (end > this->_dirtyfrom))
+        return;
+
+    QByteArray before = this->previousData(start, end - start);
+    QByteArray after = this->_document->read(start, end - start);
+
+    if(before == after) /* Already reported by a previous pass */
+        return;
+
+    this->markDirty(start, end);
+    emit dataChanged(start, before, after);
+}
+
+void MappedFile::markDirty(integer_t start, integer_t end)
+{
+    QWriteLocker locker(&this->_lock);
+    auto it = this->_dirtyranges.upperBound(start);
+
+    if(it != this->_dirtyranges.begin())
+    {
+        auto previt = it;
+        previt--;
+
+        if(previt.key() + previt.value().size() >= start)
+            it = previt;
+    }
+
+    while((it != this->_dirtyranges.end()) && (it.key() <= end))
+    {
+        start = qMin(start, it.key());
+        end = qMax(end, it.key() + it.value().size());
+        it = this->_dirtyranges.erase(it);
+    }
+
+    this->_dirtyranges[start] = this->_document->read(start, end - start);
+}
@@ -0,0 +1,57 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <QObject>
+#include <QFile>
+#include <QMap>
+#include <QReadWriteLock>
+#include <QPair>
+#include <qhexedit/document/qhexdocument.h>
+
+class MappedFile : public QObject
+{
+    Q_OBJECT
+
+    public:
+        explicit MappedFile(QHexDocument* document, const QString& filename);
+        ~MappedFile();
+        static MappedFile* fromDocument(QHexDocument* document);
+        bool isMapped() const;
+        integer_t read(integer_t offset, uchar* buffer, integer_t length);
+        const uchar* acquire(integer_t offset, integer_t length);
+        void release();
+
+    public slots:
+        void unmap();
+        void remap();
+
+    private slots:
+        void updateDirtyRanges();
+
+    signals:
+        void dataChanged(integer_t offset, const QByteArray& before, const QByteArray& after);
+        void dataInvalidated();
+
+    private:
+        integer_t dirtyLength(integer_t offset, integer_t length, bool* dirty) const;
+        QByteArray previousData(integer_t offset, integer_t length) const;
+        bool blockChanged(integer_t offset, integer_t length) const;
+        bool findChange(integer_t start, integer_t end, integer_t* changestart, integer_t* changeend) const;
+        bool findDirtyChange();
+        void invalidateMapping();
+        void applyChange(integer_t start, integer_t end);
+        void markDirty(integer_t start, integer_t end);
+
+    private:
+        static const integer_t SEARCH_WINDOW;
+        static const integer_t BLOCK_SIZE;
+        QHexDocument* _document;
+        QFile _file;
+        mutable QReadWriteLock _lock;
+        QMap<integer_t, QByteArray> _dirtyranges; /* Start -> Current Bytes */
+        integer_t _dirtyfrom;
+        integer_t _size;
+        uchar* _data;
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,156 @@
+#include "stringsfilterworker.h"
+#include <QtConcurrent>
+#include <limits>
+
+#define FOLD_ASCII(c) ((((c) >= 'A') && ((c) <= 'Z')) ? ((c) | 0x20) : (c))
+
+const int StringsFilterWorker::CHECK_INTERVAL = 0x1000;
+
+StringsFilterWorker::StringsFilterWorker(const Filter &filter, const QVector<StringArena> &batches, int firstbatch, int firstrow, QObject *parent): BasicWorker(NULL, parent), _filter(filter), _batches(batches), _firstbatch(firstbatch), _asciitext(true)
+{
+    this->_batchrows.resize(batches.size());
+
+    for(int i = firstbatch; i < batches.size(); i++)
+    {
+        this->_batchrows[i] = firstrow;
+        firstrow += batches[i].size();
+    }
+
+    if(filter.Regex)
+    {
+        this->_regex = QRegularExpression(filter.Text, QRegularExpression::CaseInsensitiveOption);
+        return;
+    }
+
+    this->_foldedtext = StringIndex::fold(filter.Text.toUtf8());
+
+    foreach(char ch, this->_foldedtext)
+    {
+        if(static_cast<uchar>(ch) & 0x80)
+        {
+            this->_asciitext = false;
+            break;
+        }
+    }
+}
+
+QVector<int> StringsFilterWorker::takeRows()
+{
+    QMutexLocker locker(&this->_mutex);
+    QVector<int> rows;
+
+    rows.swap(this->_pendingrows);
+    return rows;
+}
+
+bool StringsFilterWorker::isEmpty(const Filter &filter)
+{
+    return filter.Text.isEmpty() && !filter.From && (filter.To == std::numeric_limits<integer_t>::max()) && (filter.MinimumLength <= 0);
+}
+
+void StringsFilterWorker::run()
+{
+    this->_cancontinue = true;
+
+    if(this->_filter.Regex && !this->_regex.isValid())
+        return;
+
+    int step = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+
+    for(int i = this->_firstbatch; this->_cancontinue && (i < this->_batches.size()); i += step)
+    {
+        QVector< QPair<int, QVector<int> > > jobs; /* Batch -> Matching rows */
+
+        for(int j = i; j < qMin(i + step, this->_batches.size()); j++)
+            jobs.append(qMakePair(j, QVector<int>()));
+
+        QtConcurrent::blockingMap(jobs, [this](QPair<int, QVector<int> >& job) { job.second = this->filterBatch(job.first, this->_batchrows[job.first]); });
+
+        if(!this->_cancontinue)
+            return;
+
+        {
+            QMutexLocker locker(&this->_mutex);
+
+            for(int j = 0; j < jobs.size(); j++) /* Batches are published in order: rows stay sorted by offset */
+                this->_pendingrows += jobs[j].second;
+        }
+
+        emit rowsAvailable();
+    }
+}
+
+QVector<int> StringsFilterWorker::filterBatch(int batch, int firstrow) const
+{
+    const StringArena& arena = this->_batches[batch];
+    QVector<quint32> candidates;
+    QVector<int> rows;
+
+    if(!this->_filter.Regex && arena.candidates(this->_foldedtext, candidates)) /* The trigram index narrows plain text searches */
+    {
+        for(int i = 0; i < candidates.size(); i++)
+        {
+            if(!(i % StringsFilterWorker::CHECK_INTERVAL) && !this->_cancontinue)
+                break;
+
+            if(this->accept(arena, static_cast<int>(candidates[i])))
+                rows.append(firstrow + static_cast<int>(candidates[i]));
+        }
+
+        return rows;
+    }
+
+    for(int i = 0; i < arena.size(); i++)
+    {
+        if(!(i % StringsFilterWorker::CHECK_INTERVAL) && !this->_cancontinue)
+            break;
+
+        if(this->accept(arena, i))
+            rows.append(firstrow + i);
+    }
+
+    return rows;
+}
+
+bool StringsFilterWorker::accept(const StringArena &arena, int i) const
+{
+    const StringScanner::Match& m = arena.match(i);
+
+    if((m.Start < this->_filter.From) || (m.Start >= this->_filter.To))
+        return false;
+
+    if((this->_filter.MinimumLength > 0) && (arena.length(i) < this->_filter.MinimumLength))
+        return false;
+
+    if(this->_filter.Text.isEmpty())
+        return true;
+
+    if(this->_filter.Regex)
+        return this->_regex.match(arena.string(i)).hasMatch();
+
+    if(!this->_asciitext) /* Non ASCII case folding needs the decoded string */
+        return arena.string(i).contains(this->_filter.Text, Qt::CaseInsensitive);
+
+    int length = 0;
+    const char* s = arena.text(i, &length);
+    return this->containsText(s, length);
+}
+
+bool StringsFilterWorker::containsText(const char *s, int length) const
+{
+    const char* text = this->_foldedtext.constData();
+    int textlength = this->_foldedtext.size();
+
+    for(int i = 0; (i + textlength) <= length; i++)
+    {
+        int j = 0;
+
+        while((j < textlength) && (FOLD_ASCII(static_cast<uchar>(s[i + j])) == static_cast<uchar>(text[j])))
+            j++;
+
+        if(j == textlength)
+            return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,53 @@
+#ifndef STRINGSFILTERWORKER_H
+#define STRINGSFILTERWORKER_H
+
+#include <QVector>
+#include <QMutex>
+#include <QRegularExpression>
+#include "basicworker.h"
+#include "analysis/stringarena.h"
+
+class StringsFilterWorker : public BasicWorker
+{
+    Q_OBJECT
+
+    public:
+        struct Filter
+        {
+            QString Text;
+            bool Regex;
+            integer_t From;        /* Strings starting in [From, To) */
+            integer_t To;
+            int MinimumLength;     /* Characters */
+        };
+
+    public:
+        explicit StringsFilterWorker(const Filter& filter, const QVector<StringArena>& batches, int firstbatch, int firstrow, QObject *parent = 0);
+        QVector<int> takeRows();
+        static bool isEmpty(const Filter& filter);
+
+    protected:
+        virtual void run();
+
+    private:
+        QVector<int> filterBatch(int batch, int firstrow) const;
+        bool accept(const StringArena& arena, int i) const;
+        bool containsText(const char* s, int length) const;
+
+    signals:
+        void rowsAvailable();
+
+    private:
+        static const int CHECK_INTERVAL;
+        Filter _filter;
+        QVector<StringArena> _batches; /* Shared with the model: arenas are never modified once published */
+        QVector<int> _batchrows;
+        int _firstbatch;
+        QByteArray _foldedtext;
+        QRegularExpression _regex;
+        bool _asciitext;
+        QVector<int> _pendingrows;
+        QMutex _mutex;
+};
+
+#endif // STRINGSFILTERWORKER_H
@@ -0,0 +1,69 @@
+#include "templatecache.h"
+#include <QFileInfo>
+
+const int TemplateCache::CAPACITY = 4; /* Results */
+
+TemplateCache::TemplateCache()
+{
+
+}
+
+TemplateResultPtr TemplateCache::find(const TemplateCache::Key &key)
+{
+    if(key.FileName.isEmpty())
+        return TemplateResultPtr();
+
+    for(int i = 0; i < this->_items.size(); i++)
+    {
+        if(!TemplateCache::matches(this->_items[i].CacheKey, key))
+            continue;
+
+        this->_items.move(i, 0);
+        return this->_items.first().Result;
+    }
+
+    return TemplateResultPtr();
+}
+
+void TemplateCache::insert(const TemplateCache::Key &key, const TemplateResultPtr &result)
+{
+    if(key.FileName.isEmpty())
+        return;
+
+    for(int i = this->_items.size() - 1; i >= 0; i--)
+    {
+        if(this->_items[i].CacheKey.FileName == key.FileName) /* Older versions of the same file can't be hit anymore */
+            this->_items.removeAt(i);
+    }
+
+    Item item;
+    item.CacheKey = key;
+    item.Result = result;
+
+    this->_items.prepend(item);
+
+    while(this->_items.size() > TemplateCache::CAPACITY)
+        this->_items.removeLast();
+}
+
+void TemplateCache::clear()
+{
+    this->_items.clear();
+}
+
+TemplateCache::Key TemplateCache::key(const QString &btfile)
+{
+    /* Included files aren't tracked: touching the main template is enough to run it again */
+    QFileInfo fileinfo(btfile);
+    Key key;
+
+    key.FileName = fileinfo.canonicalFilePath(); /* Empty if the file doesn't exist */
+    key.LastModified = fileinfo.lastModified();
+    key.Size = fileinfo.size();
+    return key;
+}
+
+bool TemplateCache::matches(const TemplateCache::Key &key1, const TemplateCache::Key &key2)
+{
+    return (key1.FileName == key2.FileName) && (key1.LastModified == key2.LastModified) && (key1.Size == key2.Size);
+}
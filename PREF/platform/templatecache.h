@@ -0,0 +1,40 @@
+#ifndef TEMPLATECACHE_H
+#define TEMPLATECACHE_H
+
+#include <QList>
+#include <QDateTime>
+#include "templateresult.h"
+
+class TemplateCache
+{
+    public:
+        struct Key
+        {
+            QString FileName; /* Canonical path */
+            QDateTime LastModified;
+            qint64 Size;
+        };
+
+    private:
+        struct Item
+        {
+            Key CacheKey;
+            TemplateResultPtr Result;
+        };
+
+    public:
+        TemplateCache();
+        TemplateResultPtr find(const Key& key);
+        void insert(const Key& key, const TemplateResultPtr& result);
+        void clear();
+        static Key key(const QString& btfile);
+
+    private:
+        static bool matches(const Key& key1, const Key& key2);
+
+    private:
+        static const int CAPACITY;
+        QList<Item> _items; /* Most recently used first */
+};
+
+#endif // TEMPLATECACHE_H
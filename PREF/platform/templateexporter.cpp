@@ -0,0 +1,151 @@
+#include "templateexporter.h"
+
+const char TemplateExporter::MAGIC[] = "PREFCOL1";
+const int TemplateExporter::BLOCK_SIZE = 0x10000; /* Entries */
+
+TemplateExporter::TemplateExporter(const QString &filename): _file(filename)
+{
+    this->_stream.setByteOrder(QDataStream::LittleEndian);
+}
+
+TemplateExporter::~TemplateExporter()
+{
+    if(this->_file.isOpen()) /* Never closed: the export didn't complete */
+        this->discard();
+}
+
+QString TemplateExporter::errorString() const
+{
+    if((this->_file.error() == QFile::NoError) && (this->_stream.status() != QDataStream::Ok))
+        return QString("Write failed");
+
+    return this->_file.errorString();
+}
+
+bool TemplateExporter::hasError() const
+{
+    return (this->_file.error() != QFile::NoError) || (this->_stream.status() != QDataStream::Ok);
+}
+
+bool TemplateExporter::open()
+{
+    if(!this->_file.open(QFile::WriteOnly | QFile::Truncate))
+        return false;
+
+    this->_stream.setDevice(&this->_file);
+    this->_stream.writeRawData(TemplateExporter::MAGIC, sizeof(TemplateExporter::MAGIC) - 1);
+    return true;
+}
+
+bool TemplateExporter::append(const BTEntryPtr &btentry)
+{
+    if(this->hasError())
+        return false;
+
+    const VMValuePtr& value = btentry->value;
+
+    this->_nameids.append(this->dictionaryId(QString::fromStdString(btentry->name), this->_names, this->_addednames));
+    this->_typeids.append(this->dictionaryId(QString::fromStdString(value->value_typeid), this->_types, this->_addedtypes));
+    this->_offsets.append(btentry->location.offset);
+    this->_sizes.append(btentry->location.size);
+
+    if(value->is_struct() || value->is_union()) /* Members are exported on their own */
+        this->_valuelengths.append(0);
+    else
+    {
+        QByteArray s = QByteArray::fromStdString(value->printable(10));
+        this->_valuelengths.append(static_cast<quint32>(s.size()));
+        this->_values.append(s);
+    }
+
+    if(this->_nameids.size() >= TemplateExporter::BLOCK_SIZE)
+        this->flushBlock();
+
+    return !this->hasError();
+}
+
+bool TemplateExporter::close()
+{
+    if(!this->_file.isOpen() || this->hasError())
+        return false;
+
+    this->flushBlock();
+    this->_stream << static_cast<quint32>(0);
+
+    if(!this->_file.flush() || this->hasError())
+        return false;
+
+    this->_stream.setDevice(NULL);
+    this->_file.close();
+    return true;
+}
+
+void TemplateExporter::discard()
+{
+    this->_stream.setDevice(NULL);
+    this->_file.remove(); /* Closes it first */
+}
+
+quint32 TemplateExporter::dictionaryId(const QString &s, QHash<QString, quint32> &dictionary, QStringList &added)
+{
+    auto it = dictionary.constFind(s);
+
+    if(it != dictionary.constEnd())
+        return it.value();
+
+    quint32 id = static_cast<quint32>(dictionary.size());
+    dictionary[s] = id;
+    added.append(s);
+    return id;
+}
+
+void TemplateExporter::writeString(const QByteArray &s)
+{
+    this->_stream << static_cast<quint32>(s.size());
+    this->_stream.writeRawData(s.constData(), s.size());
+}
+
+void TemplateExporter::writeStrings(const QStringList &sl)
+{
+    this->_stream << static_cast<quint32>(sl.size());
+
+    foreach(const QString& s, sl)
+        this->writeString(s.toUtf8());
+}
+
+void TemplateExporter::flushBlock()
+{
+    if(this->_nameids.isEmpty())
+        return;
+
+    this->_stream << static_cast<quint32>(this->_nameids.size());
+    this->writeStrings(this->_addednames);
+    this->writeStrings(this->_addedtypes);
+
+    foreach(quint32 nameid, this->_nameids)
+        this->_stream << nameid;
+
+    foreach(quint32 typeid_, this->_typeids)
+        this->_stream << typeid_;
+
+    foreach(quint64 offset, this->_offsets)
+        this->_stream << offset;
+
+    foreach(quint64 size, this->_sizes)
+        this->_stream << size;
+
+    foreach(quint32 valuelength, this->_valuelengths)
+        this->_stream << valuelength;
+
+    this->_stream.writeRawData(this->_values.constData(), this->_values.size());
+
+    /* Only the dictionaries outlive a block */
+    this->_addednames.clear();
+    this->_addedtypes.clear();
+    this->_nameids.clear();
+    this->_typeids.clear();
+    this->_offsets.clear();
+    this->_sizes.clear();
+    this->_valuelengths.clear();
+    this->_values.clear();
+}
@@ -0,0 +1,54 @@
+#ifndef TEMPLATEEXPORTER_H
+#define TEMPLATEEXPORTER_H
+
+#include <QFile>
+#include <QDataStream>
+#include <QHash>
+#include <QVector>
+#include <QStringList>
+#include <bt/btvm/btvm.h>
+
+/*
+ * Columnar layout, little endian:
+ *   "PREFCOL1"
+ *   Blocks of up to BLOCK_SIZE entries:
+ *     u32 rows (0 ends the file)
+ *     u32 count + strings: names added to the dictionary by this block
+ *     u32 count + strings: types added to the dictionary by this block
+ *     u32[rows] name ids, u32[rows] type ids, u64[rows] offsets, u64[rows] sizes
+ *     u32[rows] value lengths, then the UTF-8 values back to back
+ *   Strings are stored as u32 length + UTF-8 bytes.
+ * Incomplete exports are removed: a file with the end marker is always whole.
+ */
+
+class TemplateExporter
+{
+    public:
+        TemplateExporter(const QString& filename);
+        ~TemplateExporter();
+        QString errorString() const;
+        bool hasError() const;
+        bool open();
+        bool append(const BTEntryPtr& btentry);
+        bool close();
+        void discard();
+
+    private:
+        quint32 dictionaryId(const QString& s, QHash<QString, quint32>& dictionary, QStringList& added);
+        void writeString(const QByteArray& s);
+        void writeStrings(const QStringList& sl);
+        void flushBlock();
+
+    private:
+        static const char MAGIC[];
+        static const int BLOCK_SIZE;
+        QFile _file;
+        QDataStream _stream;
+        QHash<QString, quint32> _names, _types;
+        QStringList _addednames, _addedtypes;
+        QVector<quint32> _nameids, _typeids, _valuelengths;
+        QVector<quint64> _offsets, _sizes;
+        QByteArray _values;
+};
+
+#endif // TEMPLATEEXPORTER_H
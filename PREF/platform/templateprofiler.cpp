@@ -0,0 +1,60 @@
+#include "templateprofiler.h"
+#include <QObject>
+
+TemplateProfiler::TemplateProfiler(): _lastmark(0)
+{
+
+}
+
+void TemplateProfiler::start()
+{
+    this->_indexes.clear();
+    this->_records.clear();
+    this->_lastmark = 0;
+    this->_timer.start();
+}
+
+void TemplateProfiler::entryCreated(const BTEntryPtr &btentry)
+{
+    qint64 now = this->_timer.nsecsElapsed();
+    Record& r = this->record(QString::fromStdString(btentry->value->value_typeid));
+
+    r.Count++;
+    r.Time += now - this->_lastmark;
+    r.Bytes += btentry->location.size;
+    this->_lastmark = now;
+}
+
+void TemplateProfiler::resume()
+{
+    this->_lastmark = this->_timer.nsecsElapsed(); /* Time spent by the caller since entryCreated() isn't charged */
+}
+
+TemplateProfiler::RecordList TemplateProfiler::finish()
+{
+    qint64 now = this->_timer.nsecsElapsed();
+
+    if(now > this->_lastmark) /* Code running after the last declaration */
+        this->record(QObject::tr("<no entry>")).Time += now - this->_lastmark;
+
+    this->_lastmark = now;
+    return this->_records;
+}
+
+TemplateProfiler::Record &TemplateProfiler::record(const QString &typename_)
+{
+    auto it = this->_indexes.constFind(typename_);
+
+    if(it != this->_indexes.constEnd())
+        return this->_records[it.value()];
+
+    Record r;
+    r.TypeName = typename_;
+    r.Count = 0;
+    r.Time = 0;
+    r.Bytes = 0;
+
+    this->_indexes[typename_] = this->_records.size();
+    this->_records.append(r);
+    return this->_records.last();
+}
@@ -0,0 +1,39 @@
+#ifndef TEMPLATEPROFILER_H
+#define TEMPLATEPROFILER_H
+
+#include <QHash>
+#include <QVector>
+#include <QElapsedTimer>
+#include <bt/btvm/btvm.h>
+
+class TemplateProfiler /* The VM only reports created entries: time spent between two of them is charged to the latter's type */
+{
+    public:
+        struct Record
+        {
+            QString TypeName;
+            int Count;
+            qint64 Time;       /* Nanoseconds */
+            integer_t Bytes;
+        };
+
+        typedef QVector<Record> RecordList;
+
+    public:
+        TemplateProfiler();
+        void start();
+        void entryCreated(const BTEntryPtr& btentry);
+        void resume();
+        RecordList finish();
+
+    private:
+        Record& record(const QString& typename_);
+
+    private:
+        QElapsedTimer _timer;
+        qint64 _lastmark;
+        QHash<QString, int> _indexes; /* Type -> Record */
+        RecordList _records;
+};
+
+#endif // TEMPLATEPROFILER_H
@@ -0,0 +1,13 @@
+#include "templateresult.h"
+
+TemplateResult::TemplateResult(QHexDocument *document)
+{
+    this->Data = new LoadedData(document);
+}
+
+TemplateResult::~TemplateResult()
+{
+    qDeleteAll(this->Arrays);
+    this->Template.clear(); /* Entries may still read through the buffer */
+    delete this->Data;
+}
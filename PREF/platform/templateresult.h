@@ -0,0 +1,45 @@
+#ifndef TEMPLATERESULT_H
+#define TEMPLATERESULT_H
+
+#include <QHash>
+#include <QStringList>
+#include <QSharedPointer>
+#include "loadeddata.h"
+#include "highlighttable.h"
+#include "btvmex.h"
+#include "templateprofiler.h"
+
+struct TemplateResult /* Everything a finished execution leaves behind, shared by the model and the cache */
+{
+    struct LazyArray /* Array of primitives kept as a descriptor, elements are decoded when displayed */
+    {
+        BTEntry* Entry;
+        QString Value;    /* Printable value of the whole array, taken before the elements are released */
+        QString TypeName;
+        integer_t Base;
+        integer_t Stride;
+        int Count;
+        int Type;         /* DataDecoder::Type */
+    };
+
+    typedef QHash<BTEntry*, LazyArray*> LazyArrays;
+    typedef QHash<const BTEntry*, int> EntryRows;
+
+    TemplateResult(QHexDocument* document);
+    ~TemplateResult();
+
+    LoadedData* Data;          /* Entries read through it */
+    BTEntryList Template;
+    LazyArrays Arrays;
+    EntryRows Rows;            /* Row of every entry among its siblings */
+    HighlightTable Highlights;
+    QStringList Output;        /* Printed lines, replayed when the result comes from the cache */
+    TemplateProfiler::RecordList Profile; /* Empty unless profiled */
+
+    private:
+        Q_DISABLE_COPY(TemplateResult)
+};
+
+typedef QSharedPointer<TemplateResult> TemplateResultPtr;
+
+#endif // TEMPLATERESULT_H
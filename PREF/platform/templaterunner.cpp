@@ -0,0 +1,131 @@
+#include "templaterunner.h"
+#include "loadeddata.h"
+#include <QtConcurrent>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QFileInfo>
+#include <QDir>
+#include <exception>
+
+TemplateRunner::TemplateRunner(const QString &btfile, QIODevice *output): _btfile(btfile), _output(output)
+{
+
+}
+
+int TemplateRunner::run(const QStringList &files)
+{
+    QAtomicInt failed(0);
+
+    /* Every file gets its own document and VM: nothing is shared between pool threads but the output */
+    QtConcurrent::blockingMap(files, [this, &failed](const QString& file) {
+        if(!this->runFile(file))
+            failed.ref();
+    });
+
+    return failed.load();
+}
+
+QStringList TemplateRunner::expandFiles(const QStringList &patterns)
+{
+    QStringList files;
+
+    foreach(const QString& pattern, patterns)
+    {
+        QFileInfo fileinfo(pattern);
+
+        if(!fileinfo.fileName().contains(QRegExp("[*?\\[]")))
+        {
+            files.append(pattern);
+            continue;
+        }
+
+        QDir dir = fileinfo.dir();
+
+        foreach(const QString& filename, dir.entryList(QStringList(fileinfo.fileName()), QDir::Files, QDir::Name))
+            files.append(dir.filePath(filename));
+    }
+
+    return files;
+}
+
+bool TemplateRunner::runFile(const QString &file)
+{
+    QJsonObject jsonobject;
+    jsonobject["file"] = file;
+
+    if(!QFileInfo(file).isFile())
+    {
+        jsonobject["error"] = QString("Cannot open file");
+        this->writeLine(jsonobject);
+        return false;
+    }
+
+    QHexDocument* document = QHexDocument::fromFile(file);
+    LoadedData* loadeddata = new LoadedData(document);
+    BTVMEX* btvm = new BTVMEX(loadeddata);
+    QJsonArray output, entries;
+    bool success = true;
+
+    QObject::connect(btvm, &BTVMEX::printed, [&output](const QString& s) { output.append(s); });
+
+    try
+    {
+        btvm->execute(this->_btfile.toStdString());
+        BTEntryList btentries = btvm->createTemplate();
+
+        for(auto it = btentries.begin(); it != btentries.end(); it++)
+            entries.append(TemplateRunner::entryObject(*it));
+    }
+    catch(std::exception& e)
+    {
+        jsonobject["error"] = QString::fromStdString(e.what());
+        success = false;
+    }
+
+    jsonobject["entries"] = entries;
+
+    if(!output.isEmpty())
+        jsonobject["output"] = output;
+
+    this->writeLine(jsonobject);
+
+    delete btvm; /* Entries read through the buffer */
+    delete loadeddata;
+    delete document;
+    return success;
+}
+
+void TemplateRunner::writeLine(const QJsonObject &jsonobject)
+{
+    QByteArray line = QJsonDocument(jsonobject).toJson(QJsonDocument::Compact);
+    line.append('\n');
+
+    QMutexLocker locker(&this->_mutex); /* Lines complete in any order, but never interleave */
+    this->_output->write(line);
+}
+
+QJsonObject TemplateRunner::entryObject(const BTEntryPtr &btentry)
+{
+    QJsonObject jsonobject;
+    jsonobject["name"] = QString::fromStdString(btentry->name);
+    jsonobject["type"] = QString::fromStdString(btentry->value->value_typeid);
+    jsonobject["offset"] = static_cast<double>(btentry->location.offset);
+    jsonobject["size"] = static_cast<double>(btentry->location.size);
+
+    if(!btentry->value->value_comment.empty())
+        jsonobject["comment"] = QString::fromStdString(btentry->value->value_comment);
+
+    if(btentry->children.empty())
+    {
+        jsonobject["value"] = QString::fromStdString(btentry->value->printable(10));
+        return jsonobject;
+    }
+
+    QJsonArray children;
+
+    for(auto it = btentry->children.begin(); it != btentry->children.end(); it++)
+        children.append(TemplateRunner::entryObject(*it));
+
+    jsonobject["children"] = children;
+    return jsonobject;
+}
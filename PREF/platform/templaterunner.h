@@ -0,0 +1,28 @@
+#ifndef TEMPLATERUNNER_H
+#define TEMPLATERUNNER_H
+
+#include <QStringList>
+#include <QJsonObject>
+#include <QIODevice>
+#include <QMutex>
+#include "btvmex.h"
+
+class TemplateRunner /* Applies a template to many files without any widget, one JSON object per line */
+{
+    public:
+        TemplateRunner(const QString& btfile, QIODevice* output);
+        int run(const QStringList& files);
+        static QStringList expandFiles(const QStringList& patterns);
+
+    private:
+        bool runFile(const QString& file);
+        void writeLine(const QJsonObject& jsonobject);
+        static QJsonObject entryObject(const BTEntryPtr& btentry);
+
+    private:
+        QString _btfile;
+        QIODevice* _output;
+        QMutex _mutex;
+};
+
+#endif // TEMPLATERUNNER_H
@@ -0,0 +1,316 @@
+#include "templateworker.h"
+#include "datadecoder.h"
+#include <cmath>
+
+const size_t TemplateWorker::LAZY_THRESHOLD = 0x400;
+const size_t TemplateWorker::SAMPLE_COUNT = 16;
+const integer_t TemplateWorker::SCAN_BLOCK_SIZE = 0x10000; /* Bytes */
+
+static bool sameNumber(const QVariant& decoded, const QString& printed)
+{
+    bool ok = false;
+
+    if(decoded.type() == QVariant::Double) /* printable() rounds: compare with a relative tolerance */
+    {
+        double d = decoded.toDouble(), v = printed.toDouble(&ok);
+
+        if(!ok)
+            return false;
+
+        if(std::isnan(d) || std::isnan(v))
+            return std::isnan(d) && std::isnan(v);
+
+        if(std::isinf(d) || std::isinf(v))
+            return d == v;
+
+        return std::fabs(d - v) <= ((qMax(std::fabs(d), std::fabs(v)) * 1e-6) + 1e-6);
+    }
+
+    if(decoded.type() == QVariant::LongLong)
+        return (printed.toLongLong(&ok) == decoded.toLongLong()) && ok;
+
+    if(decoded.type() == QVariant::ULongLong)
+        return (printed.toULongLong(&ok) == decoded.toULongLong()) && ok;
+
+    return false;
+}
+
+TemplateWorker::TemplateWorker(QHexDocument *document, const QString &btfile, const QString &exportfile, bool profile, QObject *parent) : BasicWorker(document, parent), _btfile(btfile), _exporter(NULL), _profiler(NULL)
+{
+    this->_result = TemplateResultPtr(new TemplateResult(document));
+    this->_btvm = new BTVMEX(this->_result->Data, this);
+
+    if(!exportfile.isEmpty())
+    {
+        this->_exporter = new TemplateExporter(exportfile);
+        this->_btvm->setExporter(this->_exporter);
+    }
+
+    if(profile)
+    {
+        this->_profiler = new TemplateProfiler();
+        this->_btvm->setProfiler(this->_profiler);
+    }
+
+    /* Emitted from the worker thread: queued to the receivers */
+    connect(this->_btvm, &BTVMEX::progressChanged, this, &TemplateWorker::progressChanged, Qt::DirectConnection);
+    connect(this->_btvm, &BTVMEX::printed, this, &TemplateWorker::printed, Qt::DirectConnection);
+    connect(this->_btvm, &BTVMEX::printed, this, &TemplateWorker::appendOutput, Qt::DirectConnection);
+}
+
+TemplateWorker::~TemplateWorker()
+{
+    delete this->_btvm; /* Before the buffer it reads from */
+    delete this->_exporter;
+    delete this->_profiler;
+}
+
+bool TemplateWorker::isAborted() const
+{
+    return this->_btvm->isAborted();
+}
+
+TemplateResultPtr TemplateWorker::takeResult()
+{
+    TemplateResultPtr result;
+    result.swap(this->_result);
+    return result;
+}
+
+void TemplateWorker::abort()
+{
+    BasicWorker::abort();
+    this->_btvm->abort();
+}
+
+void TemplateWorker::run()
+{
+    if(this->_exporter && !this->_exporter->open())
+    {
+        emit printed(tr("Cannot export template: %1").arg(this->_exporter->errorString()));
+        this->_btvm->abort();
+        return;
+    }
+
+    if(this->_profiler)
+        this->_profiler->start();
+
+    bool failed = false;
+
+    try
+    {
+        this->_btvm->execute(this->_btfile.toStdString());
+
+        if(this->_profiler) /* Only the VM is measured */
+            this->_result->Profile = this->_profiler->finish();
+
+        if(!this->_btvm->isAborted())
+            this->_result->Template = this->_btvm->createTemplate();
+
+        this->compactEntries(this->_result->Template);
+        this->indexEntries(this->_result->Template); /* Once the tree stops changing */
+        this->_btvm->buildHighlights();
+        this->_result->Highlights = this->_btvm->highlights();
+    }
+    catch(BTVMEX::Aborted&)
+    {
+        this->_result->Template.clear();
+    }
+    catch(std::exception& e)
+    {
+        emit printed(tr("Template execution failed: %1").arg(QString::fromStdString(e.what())));
+        this->_result->Template.clear();
+        failed = true;
+    }
+
+    if(this->_exporter)
+        this->finishExport(failed);
+}
+
+void TemplateWorker::finishExport(bool failed)
+{
+    QString reason;
+
+    if(this->_exporter->hasError()) /* Write errors abort the VM too */
+        reason = this->_exporter->errorString();
+    else if(failed)
+        reason = tr("execution failed");
+    else if(this->_btvm->isAborted())
+        reason = tr("execution aborted");
+    else if(this->_exporter->close())
+        return;
+    else
+        reason = this->_exporter->errorString();
+
+    this->_exporter->discard(); /* No end marker: partial files never look complete */
+    emit printed(tr("Template export failed (%1): the file has been removed").arg(reason));
+}
+
+void TemplateWorker::appendOutput(const QString &s)
+{
+    this->_result->Output.append(s);
+}
+
+void TemplateWorker::compactEntries(const BTEntryList &btentries)
+{
+    for(auto it = btentries.begin(); this->_cancontinue && (it != btentries.end()); it++)
+    {
+        if(!this->compactArray(*it))
+            this->compactEntries((*it)->children);
+    }
+}
+
+void TemplateWorker::indexEntries(const BTEntryList &btentries)
+{
+    for(size_t i = 0; this->_cancontinue && (i < btentries.size()); i++)
+    {
+        this->_result->Rows[btentries[i].get()] = static_cast<int>(i);
+        this->indexEntries(btentries[i]->children);
+    }
+}
+
+bool TemplateWorker::compactArray(const BTEntryPtr &btentry)
+{
+    const BTEntryList& elements = btentry->children;
+
+    if(elements.size() < TemplateWorker::LAZY_THRESHOLD)
+        return false;
+
+    const BTEntryPtr& first = elements.front();
+
+    if(!first->value->is_integer() && !first->value->is_floating_point())
+        return false;
+
+    integer_t base = first->location.offset, stride = first->location.size;
+
+    for(size_t i = 0; i < elements.size(); i++)
+    {
+        const BTEntryPtr& element = elements[i];
+
+        if((element->location.offset != base + (i * stride)) || (element->location.size != stride) || !element->children.empty())
+            return false;
+
+        if((element->value->value_typeid != first->value->value_typeid) || !element->value->value_comment.empty())
+            return false;
+    }
+
+    int type = this->elementType(elements, stride);
+
+    if(type == -1)
+        return false;
+
+    TemplateResult::LazyArray* lazyarray = new TemplateResult::LazyArray();
+    lazyarray->Entry = btentry.get();
+    lazyarray->Value = QString::fromStdString(btentry->value->printable(16));
+    lazyarray->TypeName = QString::fromStdString(first->value->value_typeid);
+    lazyarray->Base = base;
+    lazyarray->Stride = stride;
+    lazyarray->Count = static_cast<int>(elements.size());
+    lazyarray->Type = type;
+
+    /* Highlights are already recorded: the elements can go */
+    btentry->children.clear();
+    btentry->value->m_value.clear();
+
+    this->_result->Arrays[lazyarray->Entry] = lazyarray;
+    return true;
+}
+
+int TemplateWorker::elementType(const BTEntryList &elements, integer_t stride) const
+{
+    const VMValuePtr& first = elements.front()->value;
+    int letype = -1, betype = -1;
+
+    if(first->is_floating_point())
+    {
+        if(stride == 4)
+        {
+            letype = DataDecoder::FloatLE;
+            betype = DataDecoder::FloatBE;
+        }
+        else if(stride == 8)
+        {
+            letype = DataDecoder::DoubleLE;
+            betype = DataDecoder::DoubleBE;
+        }
+    }
+    else if(first->is_integer())
+    {
+        bool issigned = first->is_signed(); /* The VM's type, not its name: DWORD, ULONG and QWORD are unsigned */
+
+        if(stride == 1)
+            letype = betype = (issigned ? DataDecoder::Int8 : DataDecoder::UInt8);
+        else if(stride == 2)
+        {
+            letype = issigned ? DataDecoder::Int16LE : DataDecoder::UInt16LE;
+            betype = issigned ? DataDecoder::Int16BE : DataDecoder::UInt16BE;
+        }
+        else if(stride == 4)
+        {
+            letype = issigned ? DataDecoder::Int32LE : DataDecoder::UInt32LE;
+            betype = issigned ? DataDecoder::Int32BE : DataDecoder::UInt32BE;
+        }
+        else if(stride == 8)
+        {
+            letype = issigned ? DataDecoder::Int64LE : DataDecoder::UInt64LE;
+            betype = issigned ? DataDecoder::Int64BE : DataDecoder::UInt64BE;
+        }
+    }
+
+    if(letype == -1)
+        return -1;
+
+    int type = (letype == betype) ? letype : this->elementByteOrder(elements, stride, letype, betype);
+
+    if(type == -1)
+        return -1;
+
+    /* The decoder must agree with the VM on a few samples too */
+    for(size_t i = 0; i < TemplateWorker::SAMPLE_COUNT; i++)
+    {
+        const BTEntryPtr& element = elements[(i * elements.size()) / TemplateWorker::SAMPLE_COUNT];
+        QByteArray data = this->_document->read(element->location.offset, stride);
+
+        if(!sameNumber(DataDecoder::decodeNumber(type, reinterpret_cast<const uchar*>(data.constData()), data.size()), QString::fromStdString(element->value->printable(10)).trimmed()))
+            return -1;
+    }
+
+    return type;
+}
+
+int TemplateWorker::elementByteOrder(const BTEntryList &elements, integer_t stride, int letype, int betype) const
+{
+    /* Only an element whose bytes aren't symmetric reads differently in either order: its VM value tells which one the VM used */
+    integer_t base = elements.front()->location.offset, count = static_cast<integer_t>(elements.size());
+    integer_t blockcount = qMax(TemplateWorker::SCAN_BLOCK_SIZE / stride, static_cast<integer_t>(1));
+
+    for(integer_t block = 0; block < count; block += blockcount)
+    {
+        integer_t n = qMin(blockcount, count - block);
+        QByteArray data = this->_document->read(base + (block * stride), n * stride);
+
+        if(static_cast<integer_t>(data.size()) < (n * stride))
+            return -1;
+
+        for(integer_t i = 0; i < n; i++)
+        {
+            const uchar* p = reinterpret_cast<const uchar*>(data.constData()) + (i * stride);
+            integer_t j = 0;
+
+            while((j < (stride / 2)) && (p[j] == p[stride - j - 1]))
+                j++;
+
+            if(j == (stride / 2))
+                continue;
+
+            QString value = QString::fromStdString(elements[block + i]->value->printable(10)).trimmed();
+            bool le = sameNumber(DataDecoder::decodeNumber(letype, p, stride), value);
+            bool be = sameNumber(DataDecoder::decodeNumber(betype, p, stride), value);
+
+            if(le != be) /* Both can still match when rounding hides the difference */
+                return le ? letype : betype;
+        }
+    }
+
+    return -1; /* No element tells: keep the array materialized rather than guessing */
+}
@@ -0,0 +1,49 @@
+#ifndef TEMPLATEWORKER_H
+#define TEMPLATEWORKER_H
+
+#include "basicworker.h"
+#include "templateresult.h"
+
+class TemplateWorker : public BasicWorker
+{
+    Q_OBJECT
+
+    public:
+        explicit TemplateWorker(QHexDocument *document, const QString& btfile, const QString& exportfile, bool profile, QObject *parent = 0);
+        ~TemplateWorker();
+        bool isAborted() const;
+        TemplateResultPtr takeResult();
+
+    public slots:
+        virtual void abort();
+
+    protected:
+        virtual void run();
+
+    private slots:
+        void appendOutput(const QString& s);
+
+    private:
+        void finishExport(bool failed);
+        void compactEntries(const BTEntryList& btentries);
+        bool compactArray(const BTEntryPtr& btentry);
+        int elementType(const BTEntryList& elements, integer_t stride) const;
+        int elementByteOrder(const BTEntryList& elements, integer_t stride, int letype, int betype) const;
+        void indexEntries(const BTEntryList& btentries);
+
+    signals:
+        void progressChanged(integer_t covered, int entries);
+        void printed(const QString& s);
+
+    private:
+        QString _btfile;
+        TemplateResultPtr _result;
+        TemplateExporter* _exporter;
+        TemplateProfiler* _profiler;
+        BTVMEX* _btvm;
+        static const size_t LAZY_THRESHOLD;
+        static const size_t SAMPLE_COUNT;
+        static const integer_t SCAN_BLOCK_SIZE;
+};
+
+#endif // TEMPLATEWORKER_H
@@ -1,81 +1,270 @@
 #include "binarynavigator.h"
+#include "../platform/mappedfile.h"
 #include <QMouseEvent>
 #include <QPainter>
-#include <QtMath>
 
-const uint64_t BinaryNavigator::BYTES_PER_LINE = 0x10;
+const integer_t BinaryNavigator::BYTES_PER_LINE = 0x10; /* Cells */
+const int BinaryNavigator::MAX_ZOOM = 16;
 
-BinaryNavigator::BinaryNavigator(QWidget *parent): QWidget(parent), _hexedit(NULL), _loadeddata(NULL), _squaresize(0), _offset(0)
+BinaryNavigator::BinaryNavigator(QWidget *parent): QWidget(parent), _hexedit(NULL), _analysisscheduler(NULL), _categorymapconsumer(NULL), _mode(BinaryNavigator::Class), _blocksize(0), _squaresize(1), _viewstart(0), _viewlength(0), _zoom(0)
 {
-    this->_binarymap.setMode(BinaryMap::Class);
-
     this->setMinimumWidth(128);
     this->setMaximumWidth(128);
 }
 
 void BinaryNavigator::displayDefault()
 {
-    this->_binarymap.setMode(BinaryMap::Class);
-    this->renderMap();
+    this->_mode = BinaryNavigator::Class;
+    this->_image = QImage();
+    this->update();
 }
 
 void BinaryNavigator::switchView()
 {
-    BinaryMap::MapMode mode = (this->_binarymap.mode() == BinaryMap::Class) ? BinaryMap::Entropy : BinaryMap::Class;
-
-    this->_binarymap.setMode(mode);
-    this->renderMap();
+    this->_mode = (this->_mode == BinaryNavigator::Class) ? BinaryNavigator::Entropy : BinaryNavigator::Class;
+    this->_image = QImage();
+    this->update();
 }
 
-void BinaryNavigator::initialize(QHexEdit *hexedit, LoadedData* loadeddata)
+void BinaryNavigator::initialize(QHexEdit *hexedit, AnalysisScheduler *analysisscheduler)
 {
+    QHexDocument* document = hexedit->document();
+
     this->_hexedit = hexedit;
-    this->_loadeddata = loadeddata;
+    this->_analysisscheduler = analysisscheduler;
+    this->_categorymapconsumer = new CategoryMapConsumer(this); /* Whole file block summaries, filled by the shared analysis pass */
+    analysisscheduler->schedule(this->_categorymapconsumer);
+
+    connect(this->_categorymapconsumer, &CategoryMapConsumer::completed, this, &BinaryNavigator::updatePyramid);
+    connect(document->cursor(), &QHexCursor::positionChanged, this, &BinaryNavigator::updateCursor);
+
+    connect(this->_hexedit, &QHexEdit::verticalScroll, this, [this](integer_t) { /* Nothing to compute: the overview only moves when zoomed */
+        this->adjust();
+        this->update();
+    });
+
+    MappedFile* mappedfile = MappedFile::fromDocument(document);
 
-    connect(this->_hexedit->document()->cursor(), &QHexCursor::positionChanged, this, &BinaryNavigator::updateSquare);
-    connect(this->_hexedit, &QHexEdit::verticalScroll, [this](integer_t) { this->renderMap(); });
-    this->renderMap();
+    if(mappedfile)
+    {
+        connect(mappedfile, &MappedFile::dataChanged, this, &BinaryNavigator::applyChange);
+        connect(mappedfile, &MappedFile::dataInvalidated, this, &BinaryNavigator::invalidate);
+    }
+    else
+        connect(document, &QHexDocument::documentChanged, this, &BinaryNavigator::invalidate);
+
+    this->adjust();
 }
 
-void BinaryNavigator::renderMap()
+integer_t BinaryNavigator::cellCount() const
 {
-    if(!this->_loadeddata)
-        return;
+    return (this->height() / this->_squaresize) * BinaryNavigator::BYTES_PER_LINE;
+}
 
-    this->adjust();
-    this->_binarymap.elaborate(this->_loadeddata, this->_offset, this->_endoffset, BinaryNavigator::BYTES_PER_LINE);
-    this->update();
+integer_t BinaryNavigator::cellOffset(integer_t cell) const
+{
+    integer_t cells = qMax(this->cellCount(), static_cast<integer_t>(1));
+    return this->_viewstart + ((cell * this->_viewlength) / cells);
+}
+
+integer_t BinaryNavigator::offsetFromPoint(const QPoint &pt) const
+{
+    integer_t y = pt.y() / this->_squaresize;
+    integer_t x = qMin(static_cast<integer_t>(pt.x()) / this->_squaresize, BinaryNavigator::BYTES_PER_LINE - 1);
+
+    return this->cellOffset(x + (y * BinaryNavigator::BYTES_PER_LINE));
+}
+
+const CategoryMapConsumer::BlockInfo *BinaryNavigator::blockAt(integer_t offset, int level) const
+{
+    const CategoryMapConsumer::BlockList& nodes = this->_pyramid[level];
+
+    if(nodes.isEmpty())
+        return NULL;
+
+    integer_t index = qMin(offset / (this->_blocksize << level), static_cast<integer_t>(nodes.size() - 1));
+    return &nodes[index];
+}
+
+int BinaryNavigator::levelFor(integer_t cellsize) const
+{
+    int level = 0;
+
+    while(((level + 1) < this->_pyramid.size()) && ((this->_blocksize << (level + 1)) <= cellsize)) /* Coarsest node still fitting in a cell */
+        level++;
+
+    return level;
 }
 
-integer_t BinaryNavigator::offsetFromPoint(const QPoint &pt)
+QRect BinaryNavigator::cursorRect() const
 {
-    qint64 y = pt.y() / this->_squaresize;
-    qint64 x = pt.x() / this->_squaresize;
+    integer_t cursoroffset = this->_hexedit->document()->cursor()->offset();
+    integer_t cells = this->cellCount();
+
+    if(!cells || (cursoroffset < this->_viewstart) || (cursoroffset >= (this->_viewstart + this->_viewlength)))
+        return QRect();
 
-    return this->_hexedit->metrics()->visibleStartOffset() + (x + (y * BinaryNavigator::BYTES_PER_LINE));
+    integer_t cell = ((cursoroffset - this->_viewstart) * cells) / this->_viewlength;
+    int x = static_cast<int>(cell % BinaryNavigator::BYTES_PER_LINE) * this->_squaresize;
+    int y = static_cast<int>(cell / BinaryNavigator::BYTES_PER_LINE) * this->_squaresize;
+
+    return QRect(x, y, this->_squaresize, this->_squaresize);
 }
 
 void BinaryNavigator::adjust()
+{
+    integer_t viewstart = this->_viewstart, viewlength = this->_viewlength;
+    int squaresize = this->_squaresize;
+
+    this->_squaresize = qMax(this->width() / static_cast<int>(BinaryNavigator::BYTES_PER_LINE), 1);
+
+    if(!this->_hexedit)
+        return;
+
+    integer_t length = this->_hexedit->document()->length();
+    this->_viewlength = qMax(length >> this->_zoom, static_cast<integer_t>(1));
+
+    if(!this->_zoom || (this->_viewlength >= length))
+        this->_viewstart = 0;
+    else
+    {
+        integer_t visibleoffset = this->_hexedit->metrics()->visibleStartOffset();
+        integer_t half = this->_viewlength / 2;
+
+        this->_viewstart = qMin((visibleoffset > half) ? (visibleoffset - half) : 0, length - this->_viewlength);
+    }
+
+    if((viewstart != this->_viewstart) || (viewlength != this->_viewlength) || (squaresize != this->_squaresize) || (this->_image.height() != this->height() / this->_squaresize))
+        this->_image = QImage();
+}
+
+void BinaryNavigator::renderImage()
+{
+    integer_t length = this->_hexedit->document()->length();
+    integer_t cells = this->cellCount();
+    QVector<QRgb> colortable;
+    uchar none = 0;
+
+    if(this->_mode == BinaryNavigator::Entropy) /* 255 shades, the last index is left transparent */
+    {
+        for(int i = 0; i < 0xFF; i++)
+            colortable.append(QColor::fromRgb(ByteColors::entropyColor(i / 254.0)).rgb());
+
+        none = 0xFF;
+    }
+    else
+    {
+        for(int i = 0; i < CategoryMapConsumer::CategoryCount; i++)
+            colortable.append(BinaryNavigator::categoryColor(i).rgb());
+
+        none = CategoryMapConsumer::CategoryCount;
+    }
+
+    colortable.append(qRgba(0, 0, 0, 0));
+
+    this->_image = QImage(BinaryNavigator::BYTES_PER_LINE, static_cast<int>(cells / BinaryNavigator::BYTES_PER_LINE), QImage::Format_Indexed8);
+    this->_image.setColorTable(colortable);
+    this->_image.fill(none);
+
+    /* One node per cell, whatever the file size */
+    int level = this->levelFor(this->_viewlength / qMax(cells, static_cast<integer_t>(1)));
+
+    for(integer_t i = 0; i < cells; i++)
+    {
+        integer_t offset = this->cellOffset(i);
+
+        if(offset >= length)
+            break;
+
+        const CategoryMapConsumer::BlockInfo* bi = this->blockAt(offset, level);
+
+        if(!bi)
+            break;
+
+        uchar* line = this->_image.scanLine(static_cast<int>(i / BinaryNavigator::BYTES_PER_LINE));
+
+        if(this->_mode == BinaryNavigator::Entropy)
+            line[i % BinaryNavigator::BYTES_PER_LINE] = static_cast<uchar>(qBound(0.0f, bi->Entropy, 1.0f) * 254.0f);
+        else
+            line[i % BinaryNavigator::BYTES_PER_LINE] = bi->Category;
+    }
+}
+
+QColor BinaryNavigator::categoryColor(int category)
+{
+    static const uchar SAMPLES[CategoryMapConsumer::CategoryCount] = { 0x00, 0x01, 'A', 0x80, 0xFF }; /* One byte of every category */
+    return QColor(ByteColors::info(SAMPLES[category]).Color);
+}
+
+void BinaryNavigator::updateCursor()
 {
     if(!this->_hexedit)
         return;
 
-    this->_squaresize = qFloor(static_cast<qreal>(this->width()) / static_cast<qreal>(BinaryNavigator::BYTES_PER_LINE));
-    this->_offset = this->_hexedit->metrics()->visibleStartOffset();
-    this->_endoffset = qMin(this->_loadeddata->size(), this->_offset + ((this->height() / this->_squaresize) * BinaryNavigator::BYTES_PER_LINE));
+    QRect cursorrect = this->cursorRect();
+
+    if(cursorrect == this->_cursorrect)
+        return;
+
+    /* Only the overlay moves: the image is blitted again for those two squares */
+    this->update(this->_cursorrect.adjusted(-1, -1, 1, 1));
+    this->update(cursorrect.adjusted(-1, -1, 1, 1));
+    this->_cursorrect = cursorrect;
 }
 
-void BinaryNavigator::updateSquare()
+void BinaryNavigator::updatePyramid()
 {
+    this->_pyramid = this->_categorymapconsumer->pyramid();
+    this->_blocksize = this->_categorymapconsumer->windowSize();
+    this->_image = QImage();
     this->adjust();
     this->update();
 }
 
+void BinaryNavigator::applyChange(integer_t offset, const QByteArray &before, const QByteArray &after)
+{
+    if(this->_analysisscheduler->isScheduled(this->_categorymapconsumer))
+    {
+        this->invalidate(); /* The running pass may have seen either version of these bytes */
+        return;
+    }
+
+    if((before.size() != after.size()) || !this->_categorymapconsumer->refreshBlocks(this->_hexedit->document(), offset, after.size()))
+    {
+        this->invalidate();
+        return;
+    }
+
+    this->updatePyramid();
+}
+
+void BinaryNavigator::invalidate()
+{
+    this->_analysisscheduler->schedule(this->_categorymapconsumer);
+}
+
 void BinaryNavigator::wheelEvent(QWheelEvent *event)
 {
-    if(this->_hexedit && this->_loadeddata)
-        this->_hexedit->scroll(event); /* Forward Scroll */
+    if(!this->_hexedit)
+    {
+        QWidget::wheelEvent(event);
+        return;
+    }
 
+    if(event->modifiers() & Qt::ControlModifier) /* Zoom around the visible offset */
+    {
+        if(event->angleDelta().y() > 0)
+            this->_zoom = qMin(this->_zoom + 1, BinaryNavigator::MAX_ZOOM);
+        else if(event->angleDelta().y() < 0)
+            this->_zoom = qMax(this->_zoom - 1, 0);
+
+        this->adjust();
+        this->update();
+        event->accept();
+        return;
+    }
+
+    this->_hexedit->scroll(event); /* Forward Scroll */
     QWidget::wheelEvent(event);
 }
 
@@ -83,7 +272,7 @@ void BinaryNavigator::mousePressEvent(QMouseEvent *event)
 {
     if(this->_hexedit && ((event->modifiers() == Qt::NoModifier) && (event->button() == Qt::LeftButton)))
     {
-        sinteger_t offset = this->offsetFromPoint(event->pos());
+        integer_t offset = qMin(this->offsetFromPoint(event->pos()), qMax(this->_hexedit->document()->length(), static_cast<integer_t>(1)) - 1);
         QHexCursor* cursor = this->_hexedit->document()->cursor();
         cursor->setSelectionRange(offset, 1);
     }
@@ -95,48 +284,37 @@ void BinaryNavigator::mousePressEvent(QMouseEvent *event)
 
 void BinaryNavigator::paintEvent(QPaintEvent *)
 {
-    if(!this->_loadeddata || !this->_hexedit || !this->isVisible())
+    if(!this->_hexedit || !this->isVisible() || this->_pyramid.isEmpty() || this->_pyramid.first().isEmpty() || !this->cellCount())
         return;
 
-    const BinaryMap::ByteDataList& bdl = this->_binarymap.data();
-    QHexCursor* cursor = this->_hexedit->document()->cursor();
-    QRectF r(0, 0, this->_squaresize, this->_squaresize), cursorrect;
-    QPainter p(this);
+    if(this->_image.isNull())
+        this->renderImage();
 
-    for(integer_t i = 0; i < bdl.size(); i++, this->_offset++)
-    {
-        if(r.left() >= this->width())
-            r.moveTo(0, r.top() + this->_squaresize);
-
-        QColor c;
-        const BinaryMap::ByteData& bd = bdl.at(i);
-
-        if(this->_binarymap.mode() == BinaryMap::Entropy)
-            c = QColor::fromRgb(ByteColors::entropyColor(bd.Entropy));
-        else
-            c = QColor::fromRgb(ByteColors::categoryColor(bd.Category));
+    QPainter p(this);
+    p.drawImage(QRect(0, 0, this->_image.width() * this->_squaresize, this->_image.height() * this->_squaresize), this->_image); /* Not smoothed: cells stay sharp */
 
-        p.fillRect(r, c);
+    if(this->_mode == BinaryNavigator::Entropy)
+        p.setPen(QColor(0xFF, 0xFF, 0x00));
+    else
+        p.setPen(QColor(0xFF, 0x00, 0xFF));
 
-        if(this->_offset == cursor->offset())
-            cursorrect = r;
+    integer_t visibleoffset = this->_hexedit->metrics()->visibleStartOffset();
 
-        r.moveLeft(r.left() + this->_squaresize);
+    if((visibleoffset >= this->_viewstart) && (visibleoffset < (this->_viewstart + this->_viewlength))) /* Top of the hex view */
+    {
+        integer_t cell = ((visibleoffset - this->_viewstart) * this->cellCount()) / this->_viewlength;
+        int y = static_cast<int>(cell / BinaryNavigator::BYTES_PER_LINE) * this->_squaresize;
+        p.drawLine(0, y, this->width(), y);
     }
 
-    if(cursorrect.isEmpty())
-        return;
+    this->_cursorrect = this->cursorRect();
 
-    if(this->_binarymap.mode() == BinaryMap::Entropy)
-        p.setPen(QColor(0xFF, 0xFF, 0x00));
-    else
-        p.setPen(QColor(0xFF, 0x00, 0xFF));
-
-    p.drawRect(cursorrect);
+    if(!this->_cursorrect.isNull())
+        p.drawRect(this->_cursorrect);
 }
 
 void BinaryNavigator::resizeEvent(QResizeEvent *event)
 {
     QWidget::resizeEvent(event);
-    this->renderMap();
+    this->adjust();
 }
@@ -2,33 +2,45 @@
 #define BINARYNAVIGATOR_H
 
 #include <QWidget>
-#include <map/binarymap.h>
+#include <QImage>
 #include <support/bytecolors.h>
 #include <qhexedit/qhexedit.h>
-#include "../platform/loadeddata.h"
+#include "../platform/analysis/analysisscheduler.h"
+#include "../platform/analysis/categorymapconsumer.h"
 
-using namespace PrefLib::Map;
 using namespace PrefLib::Support;
 
 class BinaryNavigator : public QWidget
 {
     Q_OBJECT
 
+    public:
+        enum Mode { Class, Entropy };
+
     public:
         explicit BinaryNavigator(QWidget *parent = 0);
-        void initialize(QHexEdit* hexedit, LoadedData* loadeddata);
+        void initialize(QHexEdit* hexedit, AnalysisScheduler* analysisscheduler);
 
     public slots:
         void displayDefault();
         void switchView();
 
     private:
-        integer_t offsetFromPoint(const QPoint &pt);
+        integer_t cellCount() const;
+        integer_t cellOffset(integer_t cell) const;
+        integer_t offsetFromPoint(const QPoint &pt) const;
+        const CategoryMapConsumer::BlockInfo* blockAt(integer_t offset, int level) const;
+        int levelFor(integer_t cellsize) const;
+        QRect cursorRect() const;
         void adjust();
+        void renderImage();
+        static QColor categoryColor(int category);
 
     private slots:
-        void updateSquare();
-        void renderMap();
+        void updateCursor();
+        void updatePyramid();
+        void applyChange(integer_t offset, const QByteArray& before, const QByteArray& after);
+        void invalidate();
 
     protected:
         virtual void wheelEvent(QWheelEvent* event);
@@ -37,13 +49,20 @@ class BinaryNavigator : public QWidget
         virtual void resizeEvent(QResizeEvent *event);
 
     private:
-        static const uint64_t BYTES_PER_LINE;
-        BinaryMap _binarymap;
+        static const integer_t BYTES_PER_LINE;
+        static const int MAX_ZOOM;
         QHexEdit* _hexedit;
-        LoadedData* _loadeddata;
-        uint64_t _squaresize;
-        integer_t _offset;
-        integer_t _endoffset;
+        AnalysisScheduler* _analysisscheduler;
+        CategoryMapConsumer* _categorymapconsumer;
+        CategoryMapConsumer::Pyramid _pyramid; /* Shared copy of the consumer's one, safe to read while a pass runs */
+        QImage _image;                         /* One pixel per cell, rendered again only when the view changes */
+        QRect _cursorrect;
+        Mode _mode;
+        integer_t _blocksize;
+        int _squaresize;
+        integer_t _viewstart;
+        integer_t _viewlength;
+        int _zoom;                             /* The view spans 1/2^zoom of the file */
 };
 
 #endif // BINARYNAVIGATOR_H
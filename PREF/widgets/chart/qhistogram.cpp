@@ -12,22 +12,12 @@ QHistogram::QHistogram(QWidget *parent): QWidget(parent)
     this->_margin = 30;
     this->_originX = this->_margin;
     this->_endaxisY = this->_margin;
-
-    this->_histogramchart = new HistogramChart();
-}
-
-QHistogram::~QHistogram()
-{
-    if(this->_histogramchart)
-    {
-        delete this->_histogramchart;
-        this->_histogramchart = NULL;
-    }
 }
 
-HistogramChart *QHistogram::chart() const
+void QHistogram::setResult(const ByteElaborator::CountResult &result)
 {
-    return this->_histogramchart;
+    this->_result = result;
+    this->update();
 }
 
 void QHistogram::drawAxis(QPainter& p)
@@ -45,7 +35,7 @@ void QHistogram::drawAxis(QPainter& p)
     p.drawText(QPointF(((this->_endaxisX - this->_originX) / 2) + (fm.width(nummid) / 2), this->_originY + fm.height()), nummid);
     p.drawText(QPointF(this->_endaxisX - (fm.width(numend) / 2), this->_originY + fm.height()), numend);
 
-    const ByteElaborator::CountResult& cr = this->_histogramchart->result();
+    const ByteElaborator::CountResult& cr = this->_result;
 
     if(!cr.Counts.empty() && cr.MaxCount)  /* Draw Y Axis Labels */
     {
@@ -60,7 +50,7 @@ void QHistogram::drawAxis(QPainter& p)
 void QHistogram::drawBars(QPainter &p)
 {
     qreal xpos = this->_originX;
-    const ByteElaborator::CountResult& cr = this->_histogramchart->result();
+    const ByteElaborator::CountResult& cr = this->_result;
 
     if(this->_barwidth < 2.0)
         xpos++;
@@ -90,7 +80,7 @@ void QHistogram::paintEvent(QPaintEvent*)
 
     this->drawAxis(p);
 
-    const ByteElaborator::CountResult& cr = this->_histogramchart->result();
+    const ByteElaborator::CountResult& cr = this->_result;
 
     if(!cr.Counts.empty())
         this->drawBars(p);
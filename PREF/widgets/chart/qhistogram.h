@@ -2,9 +2,9 @@
 #define QHISTOGRAM_H
 
 #include <QWidget>
-#include <chart/histogramchart.h>
+#include <support/byteelaborator.h>
 
-using namespace PrefLib::Chart;
+using namespace PrefLib::Support;
 
 class QHistogram : public QWidget
 {
@@ -12,8 +12,7 @@ class QHistogram : public QWidget
 
     public:
         explicit QHistogram(QWidget *parent = 0);
-        ~QHistogram();
-        HistogramChart* chart() const;
+        void setResult(const ByteElaborator::CountResult& result);
 
     private:
         void drawAxis(QPainter &p);
@@ -31,7 +30,7 @@ class QHistogram : public QWidget
         qreal _barwidth;
         qreal _barheight;
         quint64 _margin;
-        HistogramChart* _histogramchart;
+        ByteElaborator::CountResult _result;
 
     private: /* Constants */
         static const int BAR_COUNT;
@@ -6,16 +6,6 @@ QXYChart::QXYChart(QWidget *parent): QWidget(parent), _xbase(10), _ybase(10), _x
 {
     this->_originX = QXYChart::MARGIN;
     this->_endaxisY = QXYChart::MARGIN;
-    this->_entroypchart = new EntropyChart();
-}
-
-QXYChart::~QXYChart()
-{
-    if(this->_entroypchart)
-    {
-        delete this->_entroypchart;
-        this->_entroypchart = NULL;
-    }
 }
 
 void QXYChart::setXBase(int base)
@@ -44,9 +34,10 @@ void QXYChart::setYRange(qreal min, qreal max)
     this->update();
 }
 
-EntropyChart *QXYChart::chart() const
+void QXYChart::setPoints(const QVector<QPointF> &points)
 {
-    return this->_entroypchart;
+    this->_points = points;
+    this->update();
 }
 
 void QXYChart::drawAxis(QPainter &p)
@@ -78,9 +69,9 @@ void QXYChart::drawPoints(QPainter &p)
 {
     QPointF lastptc;
 
-    for(size_t i = 0; i < this->_entroypchart->points().size(); i++)
-    {        
-        const EntropyChart::EntropyPoint& pt = this->_entroypchart->points().at(i);
+    for(int i = 0; i < this->_points.size(); i++)
+    {
+        const QPointF& pt = this->_points.at(i);
         QPointF ptc = this->convertPoint(pt);
 
         if(!i)
@@ -89,18 +80,18 @@ void QXYChart::drawPoints(QPainter &p)
             continue;
         }
 
-        p.setPen(ByteColors::entropyColor(pt.y));
+        p.setPen(ByteColors::entropyColor(pt.y()));
         p.drawLine(lastptc, ptc);
         lastptc = ptc;
     }
 }
 
-QPointF QXYChart::convertPoint(const EntropyChart::EntropyPoint& p)
+QPointF QXYChart::convertPoint(const QPointF &p)
 {
     qreal xrange = this->_xmax - this->_xmin;
     qreal yrange = this->_ymax - this->_ymin;
-    qreal scaledx = this->_originX + (((p.x - this->_xmin) / xrange) * (this->_endaxisX - this->_originX));
-    qreal scaledy = this->_originY - (((p.y - this->_ymin) / yrange) * (this->_originY - this->_endaxisY));
+    qreal scaledx = this->_originX + (((p.x() - this->_xmin) / xrange) * (this->_endaxisX - this->_originX));
+    qreal scaledy = this->_originY - (((p.y() - this->_ymin) / yrange) * (this->_originY - this->_endaxisY));
 
     return QPointF(scaledx, scaledy);
 }
@@ -120,6 +111,6 @@ void QXYChart::paintEvent(QPaintEvent*)
 
     this->drawAxis(p);
 
-    if(!this->_entroypchart->points().empty())
+    if(!this->_points.isEmpty())
         this->drawPoints(p);
 }
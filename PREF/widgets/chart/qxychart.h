@@ -3,10 +3,8 @@
 
 #include <QWidget>
 #include <QPainter>
-#include <chart/entropychart.h>
 #include <support/bytecolors.h>
 
-using namespace PrefLib::Chart;
 using namespace PrefLib::Support;
 
 class QXYChart : public QWidget
@@ -15,18 +13,17 @@ class QXYChart : public QWidget
 
     public:
         explicit QXYChart(QWidget *parent = 0);
-        ~QXYChart();
         void setXBase(int base);
         void setYBase(int base);
         void setXRange(qreal min, qreal max);
         void setYRange(qreal min, qreal max);
-        EntropyChart* chart() const;
+        void setPoints(const QVector<QPointF>& points);
 
     private:
         void interpolate(QPainterPath &path, const QPointF& start, const QPointF &end);
         void drawAxis(QPainter &p);
         void drawPoints(QPainter& p);
-        QPointF convertPoint(const EntropyChart::EntropyPoint &p);
+        QPointF convertPoint(const QPointF &p);
 
     protected:
         virtual void resizeEvent(QResizeEvent* e);
@@ -43,7 +40,7 @@ class QXYChart : public QWidget
         qreal _originY;
         qreal _endaxisX;
         qreal _endaxisY;
-        EntropyChart* _entroypchart;
+        QVector<QPointF> _points;
 
     private:
         static const qint64 MARGIN;
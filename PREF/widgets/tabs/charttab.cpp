@@ -1,26 +1,38 @@
 #include "charttab.h"
 #include "ui_charttab.h"
-#include "../../platform/chartworker.h"
+#include "../../platform/mappedfile.h"
 #include <support/bytecolors.h>
 
 using namespace PrefLib::Support;
 
-ChartTab::ChartTab(QWidget *parent) : QWidget(parent), ui(new Ui::ChartTab)
+ChartTab::ChartTab(QWidget *parent) : QWidget(parent), ui(new Ui::ChartTab), _analysisscheduler(NULL), _bytecountconsumer(NULL), _entropyconsumer(NULL)
 {
     ui->setupUi(this);
     ui->tbSwitchChart->setIcon(QIcon(":/res/xychart.png"));
 }
 
-void ChartTab::initialize(QHexDocument *document)
+void ChartTab::initialize(QHexDocument *document, AnalysisScheduler *analysisscheduler)
 {
-    ChartWorker* chartworker = new ChartWorker(ui->chartContainer->histogram()->chart(), ui->chartContainer->xyChart()->chart(), document, this);
+    this->_analysisscheduler = analysisscheduler;
+    this->_bytecountconsumer = new ByteCountConsumer(this);
+    this->_entropyconsumer = new EntropyConsumer(this);
 
-    connect(chartworker, &ChartWorker::histogramChartCompleted, [this]() { ui->chartContainer->histogram()->update(); });
-    connect(chartworker, &ChartWorker::entropyChartCompleted, [this]() { ui->chartContainer->xyChart()->update(); });
-    connect(chartworker, &ChartWorker::entropyCalculated, this, &ChartTab::updateEntropy);
-    connect(chartworker, &ChartWorker::finished, chartworker, &ChartWorker::deleteLater);
+    connect(this->_bytecountconsumer, &ByteCountConsumer::progressChanged, this, &ChartTab::updateProgress);
+    connect(this->_bytecountconsumer, &ByteCountConsumer::completed, this, &ChartTab::updateHistogram);
+    connect(this->_entropyconsumer, &EntropyConsumer::completed, this, &ChartTab::updateEntropy);
 
-    chartworker->start();
+    MappedFile* mappedfile = MappedFile::fromDocument(document);
+
+    if(mappedfile)
+    {
+        connect(mappedfile, &MappedFile::dataChanged, this, &ChartTab::applyChange);
+        connect(mappedfile, &MappedFile::dataInvalidated, this, &ChartTab::invalidate);
+    }
+    else
+        connect(document, &QHexDocument::documentChanged, this, &ChartTab::invalidate);
+
+    analysisscheduler->schedule(this->_bytecountconsumer);
+    analysisscheduler->schedule(this->_entropyconsumer);
 }
 
 ChartTab::~ChartTab()
@@ -28,12 +40,16 @@ ChartTab::~ChartTab()
     delete ui;
 }
 
-void ChartTab::updateEntropy(double e, quint64 size)
+void ChartTab::updateProgress(int percent)
 {
-    ui->chartContainer->xyChart()->setXBase(16);
-    ui->chartContainer->xyChart()->setXRange(0, size);
-    ui->chartContainer->xyChart()->setYRange(0, 1);
+    ui->lblEntropy->setText(tr("Calculating... %1%").arg(percent));
+}
 
+void ChartTab::updateHistogram()
+{
+    double e = this->_bytecountconsumer->entropy();
+
+    ui->chartContainer->histogram()->setResult(this->_bytecountconsumer->result());
     ui->lblEntropy->setText(QString::number(e));
 
     QPalette p = ui->lblEntropy->palette();
@@ -41,6 +57,38 @@ void ChartTab::updateEntropy(double e, quint64 size)
     ui->lblEntropy->setPalette(p);
 }
 
+void ChartTab::updateEntropy()
+{
+    ui->chartContainer->xyChart()->setXBase(16);
+    ui->chartContainer->xyChart()->setXRange(0, this->_bytecountconsumer->size());
+    ui->chartContainer->xyChart()->setYRange(0, 1);
+    ui->chartContainer->xyChart()->setPoints(this->_entropyconsumer->points());
+}
+
+void ChartTab::applyChange(integer_t offset, const QByteArray &before, const QByteArray &after)
+{
+    if(this->_analysisscheduler->isScheduled(this->_bytecountconsumer) || this->_analysisscheduler->isScheduled(this->_entropyconsumer))
+    {
+        this->invalidate(); /* The running pass may have seen either version of these bytes */
+        return;
+    }
+
+    if(!this->_bytecountconsumer->update(offset, before, after) || !this->_entropyconsumer->update(offset, before, after))
+    {
+        this->invalidate();
+        return;
+    }
+
+    this->updateHistogram();
+    this->updateEntropy();
+}
+
+void ChartTab::invalidate()
+{
+    this->_analysisscheduler->schedule(this->_bytecountconsumer);
+    this->_analysisscheduler->schedule(this->_entropyconsumer);
+}
+
 void ChartTab::on_tbSwitchChart_clicked()
 {
     ui->chartContainer->switchChart();
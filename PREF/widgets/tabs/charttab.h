@@ -3,6 +3,9 @@
 
 #include <QWidget>
 #include <qhexedit/document/qhexdocument.h>
+#include "../../platform/analysis/analysisscheduler.h"
+#include "../../platform/analysis/bytecountconsumer.h"
+#include "../../platform/analysis/entropyconsumer.h"
 #include "../chart/qhistogram.h"
 #include "../chart/qxychart.h"
 
@@ -16,15 +19,22 @@ class ChartTab : public QWidget
 
     public:
         explicit ChartTab(QWidget *parent = 0);
-        void initialize(QHexDocument *document);
+        void initialize(QHexDocument *document, AnalysisScheduler *analysisscheduler);
         ~ChartTab();
 
     private slots:
         void on_tbSwitchChart_clicked();
-        void updateEntropy(double e, quint64 size);
+        void updateProgress(int percent);
+        void updateHistogram();
+        void updateEntropy();
+        void applyChange(integer_t offset, const QByteArray& before, const QByteArray& after);
+        void invalidate();
 
     private:
         Ui::ChartTab *ui;
+        AnalysisScheduler* _analysisscheduler;
+        ByteCountConsumer* _bytecountconsumer;
+        EntropyConsumer* _entropyconsumer;
 };
 
 #endif // CHARTTAB_H
@@ -1,48 +1,206 @@
 #include "stringstab.h"
 #include "ui_stringstab.h"
-#include "../../platform/stringsworker.h"
+#include <limits>
 
-StringsTab::StringsTab(QWidget *parent) : QWidget(parent), ui(new Ui::StringsTab), _stringsmodel(NULL), _proxymodel(NULL)
+const int StringsTab::FILTER_DELAY = 250;
+
+StringsTab::StringsTab(QWidget *parent) : QWidget(parent), ui(new Ui::StringsTab), _analysisscheduler(NULL), _stringsmodel(NULL), _stringsconsumer(NULL), _filterworker(NULL), _filteredbatches(0), _pass(0)
 {
     ui->setupUi(this);
+
+    this->_filtertimer = new QTimer(this);
+    this->_filtertimer->setSingleShot(true);
+    this->_filtertimer->setInterval(StringsTab::FILTER_DELAY);
+
+    connect(this->_filtertimer, &QTimer::timeout, this, &StringsTab::applyFilter);
 }
 
-void StringsTab::initialize(QHexDocument *document)
+void StringsTab::initialize(QHexDocument *, AnalysisScheduler *analysisscheduler)
 {
-    this->_stringsmodel = new StringsModel(document, this);
-
-    this->_proxymodel = new QSortFilterProxyModel(this);
-    this->_proxymodel->setFilterCaseSensitivity(Qt::CaseInsensitive);
-    this->_proxymodel->setFilterKeyColumn(-1);
-    this->_proxymodel->setSourceModel(this->_stringsmodel);
+    this->_analysisscheduler = analysisscheduler;
+    this->_stringsmodel = new StringsModel(this);
+    ui->tvStrings->setModel(this->_stringsmodel);
 
-    connect(ui->leFilter, &QLineEdit::textChanged, this->_proxymodel, &QSortFilterProxyModel::setFilterFixedString);
+    /* Restart the delay on every keystroke: only the last query runs */
+    connect(ui->leFilter, &QLineEdit::textChanged, this->_filtertimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(ui->leFrom, &QLineEdit::textChanged, this->_filtertimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(ui->leTo, &QLineEdit::textChanged, this->_filtertimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(ui->cbRegex, &QCheckBox::toggled, this->_filtertimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(ui->sbMinLength, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this->_filtertimer, static_cast<void (QTimer::*)()>(&QTimer::start));
 
-    ui->tvStrings->setModel(this->_proxymodel);
+    this->_stringsconsumer = new StringsConsumer(this);
+    ui->cbAscii->setChecked(this->_stringsconsumer->encodings() & StringScanner::Ascii);
+    ui->cbUtf8->setChecked(this->_stringsconsumer->encodings() & StringScanner::Utf8);
+    ui->cbUtf16->setChecked(this->_stringsconsumer->encodings() & StringScanner::Utf16LE);
+    ui->sbScanLength->setValue(static_cast<int>(this->_stringsconsumer->minimumLength()));
 
-    StringsWorker* stringsworker = new StringsWorker(this->_stringlist, document, this);
-    connect(stringsworker, &StringsWorker::searchEnable, ui->leFilter, &QLineEdit::setEnabled);
+    /* Scanner settings need a new pass: the scheduler coalesces quick changes */
+    connect(ui->cbAscii, &QCheckBox::toggled, this, &StringsTab::rescan);
+    connect(ui->cbUtf8, &QCheckBox::toggled, this, &StringsTab::rescan);
+    connect(ui->cbUtf16, &QCheckBox::toggled, this, &StringsTab::rescan);
+    connect(ui->sbScanLength, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &StringsTab::rescan);
 
-    connect(stringsworker, &StringsWorker::finished, [this, stringsworker]() {
-        this->_stringsmodel->initialize(this->_stringlist);
-        stringsworker->deleteLater();
-    });
+    connect(this->_stringsconsumer, &StringsConsumer::progressChanged, this, &StringsTab::updateProgress);
+    connect(this->_stringsconsumer, &StringsConsumer::stringsAvailable, this, &StringsTab::updateStrings);
+    connect(this->_stringsconsumer, &StringsConsumer::completed, this, &StringsTab::completeStrings);
 
-    stringsworker->start();
+    ui->pbStrings->setValue(0);
+    ui->pbStrings->setVisible(true);
+    analysisscheduler->schedule(this->_stringsconsumer);
 }
 
 StringsTab::~StringsTab()
 {
+    this->stopFilter();
+
+    foreach(StringsFilterWorker* filterworker, this->findChildren<StringsFilterWorker*>()) /* Aborted queries may still be winding down */
+    {
+        filterworker->abort();
+        filterworker->wait();
+    }
+
     delete ui;
 }
 
-void StringsTab::on_tvStrings_doubleClicked(const QModelIndex &index)
+void StringsTab::updateProgress(int percent)
+{
+    ui->pbStrings->setValue(percent);
+    ui->pbStrings->setVisible(true); /* A rescan may start right after the previous pass completed */
+}
+
+void StringsTab::updateStrings()
+{
+    int pass = 0;
+    QVector<StringArena> batches = this->_stringsconsumer->takeStrings(&pass);
+
+    if(pass != this->_pass) /* A new pass replaces the strings of the previous one */
+    {
+        this->resetStrings();
+        this->_pass = pass;
+    }
+
+    for(int i = 0; i < batches.size(); i++) /* Batches arrive sorted and in file order: rows are only appended */
+        this->_stringsmodel->appendStrings(std::move(batches[i]));
+
+    if(this->_stringsmodel->isFiltered())
+        this->startFilter();
+}
+
+void StringsTab::completeStrings()
 {
-    QModelIndex sourceindex = this->_proxymodel->mapToSource(index);
+    this->updateStrings();
+    ui->pbStrings->setVisible(false);
+}
+
+void StringsTab::rescan()
+{
+    int encodings = 0;
+
+    if(ui->cbAscii->isChecked())
+        encodings |= StringScanner::Ascii;
+
+    if(ui->cbUtf8->isChecked())
+        encodings |= StringScanner::Utf8;
+
+    if(ui->cbUtf16->isChecked())
+        encodings |= StringScanner::Utf16LE;
+
+    this->_stringsconsumer->setEncodings(encodings);
+    this->_stringsconsumer->setMinimumLength(ui->sbScanLength->value());
+    this->_analysisscheduler->schedule(this->_stringsconsumer);
+}
+
+void StringsTab::applyFilter()
+{
+    if(!this->_stringsmodel)
+        return;
+
+    this->stopFilter();
+    this->_filter = this->currentFilter();
+    this->_filteredbatches = 0;
+
+    if(StringsFilterWorker::isEmpty(this->_filter))
+    {
+        this->_stringsmodel->setFiltered(false);
+        return;
+    }
+
+    this->_stringsmodel->setFiltered(true);
+    this->startFilter();
+}
 
-    if(!sourceindex.isValid())
+void StringsTab::updateFilter()
+{
+    if(this->_filterworker)
+        this->_stringsmodel->appendFilteredRows(this->_filterworker->takeRows());
+}
+
+void StringsTab::filterFinished()
+{
+    this->updateFilter();
+    this->_filterworker = NULL;
+    this->startFilter(); /* Strings scanned in the meantime */
+}
+
+StringsFilterWorker::Filter StringsTab::currentFilter() const
+{
+    StringsFilterWorker::Filter filter;
+    bool ok = false;
+
+    filter.Text = ui->leFilter->text();
+    filter.Regex = ui->cbRegex->isChecked();
+    filter.From = ui->leFrom->text().toULongLong(&ok, 16);
+
+    if(!ok)
+        filter.From = 0;
+
+    filter.To = ui->leTo->text().toULongLong(&ok, 16);
+
+    if(!ok)
+        filter.To = std::numeric_limits<integer_t>::max();
+
+    filter.MinimumLength = ui->sbMinLength->value();
+    return filter;
+}
+
+void StringsTab::startFilter()
+{
+    const QVector<StringArena>& batches = this->_stringsmodel->batches();
+
+    if(this->_filterworker || (this->_filteredbatches >= batches.size()))
+        return;
+
+    this->_filterworker = new StringsFilterWorker(this->_filter, batches, this->_filteredbatches, this->_stringsmodel->batchRow(this->_filteredbatches), this);
+    this->_filteredbatches = batches.size();
+
+    connect(this->_filterworker, &StringsFilterWorker::rowsAvailable, this, &StringsTab::updateFilter);
+    connect(this->_filterworker, &StringsFilterWorker::finished, this, &StringsTab::filterFinished);
+    connect(this->_filterworker, &StringsFilterWorker::finished, this->_filterworker, &StringsFilterWorker::deleteLater);
+    this->_filterworker->start();
+}
+
+void StringsTab::stopFilter()
+{
+    if(!this->_filterworker)
+        return;
+
+    disconnect(this->_filterworker, NULL, this, NULL); /* Results of an outdated query are dropped */
+    this->_filterworker->abort();
+    this->_filterworker = NULL;
+}
+
+void StringsTab::resetStrings()
+{
+    this->stopFilter();
+    this->_filteredbatches = 0;
+    this->_stringsmodel->clear();
+}
+
+void StringsTab::on_tvStrings_doubleClicked(const QModelIndex &index)
+{
+    if(!index.isValid())
         return;
 
-    ByteElaborator::StringRange sr = this->_stringlist[sourceindex.row()];
-    emit selectString(sr.Start, sr.End);
+    const StringScanner::Match& m = this->_stringsmodel->match(index.row());
+    emit selectString(m.Start, m.End);
 }
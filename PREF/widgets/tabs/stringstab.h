@@ -2,37 +2,55 @@
 #define STRINGSTAB_H
 
 #include <QWidget>
-#include <QSortFilterProxyModel>
-#include <support/byteelaborator.h>
-#include "../../models/stringsmodel.h"
+#include <QTimer>
+#include "../../platform/analysis/analysisscheduler.h"
+#include "../../platform/stringsfilterworker.h"
+#include "../../platform/analysis/stringsconsumer.h"
 #include "../../models/stringsmodel.h"
 
 namespace Ui {
 class StringsTab;
 }
 
-using namespace PrefLib::Support;
-
 class StringsTab : public QWidget
 {
     Q_OBJECT
 
     public:
         explicit StringsTab(QWidget *parent = 0);
-        void initialize(QHexDocument *document);
+        void initialize(QHexDocument *document, AnalysisScheduler* analysisscheduler);
         ~StringsTab();
 
     private slots:
         void on_tvStrings_doubleClicked(const QModelIndex &index);
+        void updateProgress(int percent);
+        void updateStrings();
+        void completeStrings();
+        void rescan();
+        void applyFilter();
+        void updateFilter();
+        void filterFinished();
 
     signals:
         void selectString(integer_t startoffset, integer_t endoffset);
 
     private:
+        StringsFilterWorker::Filter currentFilter() const;
+        void startFilter();
+        void stopFilter();
+        void resetStrings();
+
+    private:
+        static const int FILTER_DELAY;
         Ui::StringsTab *ui;
+        AnalysisScheduler* _analysisscheduler;
         StringsModel* _stringsmodel;
-        QSortFilterProxyModel* _proxymodel;
-        ByteElaborator::StringList _stringlist;
+        StringsConsumer* _stringsconsumer;
+        StringsFilterWorker* _filterworker;
+        StringsFilterWorker::Filter _filter;
+        QTimer* _filtertimer;
+        int _filteredbatches;
+        int _pass;
 };
 
 #endif // STRINGSTAB_H
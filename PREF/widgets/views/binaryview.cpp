@@ -21,7 +21,7 @@ BinaryView::BinaryView(QHexDocument *document, QLabel *lblstatus, const QString
     ui->tvTemplate->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
     ui->dataInspector->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
 
-    this->_loadeddata = new LoadedData(document);
+    this->_mappedfile = new MappedFile(document, loadedfile);
     this->_menu = new QMenu(this);
 
     ui->hexEdit->setContextMenuPolicy(Qt::CustomContextMenu);
@@ -41,6 +41,7 @@ BinaryView::BinaryView(QHexDocument *document, QLabel *lblstatus, const QString
 
 BinaryView::~BinaryView()
 {
+    delete this->_analysisscheduler; /* The pass feeds consumers owned by the tabs: stop it before they go away */
     delete ui;
 }
 
@@ -59,6 +60,8 @@ void BinaryView::updateToolBar(QToolBar* toolbar) const
     QAction* actsave = toolbar->addAction(QIcon(":/res/save.png"), tr("Save"), this, &BinaryView::save);
     toolbar->addAction(QIcon(":/res/entropy.png"), tr("Map View"), ui->binaryNavigator, &BinaryNavigator::switchView);
     QAction* acttemplate = toolbar->addAction(QIcon(":/res/template.png"), tr("Load Template"), this, &BinaryView::loadTemplate);
+    toolbar->addAction(QIcon(":/res/export.png"), tr("Export Template"), this, &BinaryView::exportTemplate);
+    QAction* actprofile = toolbar->addAction(QIcon(":/res/cpu.png"), tr("Profile Template"));
     toolbar->addSeparator();
     QAction* actundo = toolbar->addAction(QIcon(":/res/undo.png"), tr("Undo"), document, &QHexDocument::undo);
     QAction* actredo = toolbar->addAction(QIcon(":/res/redo.png"), tr("Redo"), document, &QHexDocument::redo);
@@ -81,6 +84,10 @@ void BinaryView::updateToolBar(QToolBar* toolbar) const
     actcut->setEnabled(false);
     actcopy->setEnabled(false);
 
+    actprofile->setCheckable(true);
+    actprofile->setChecked(this->_templatemodel->isProfiling());
+    connect(actprofile, &QAction::toggled, this->_templatemodel, &TemplateModel::setProfiling);
+
     acttemplate->setShortcut(QKeySequence(Qt::Key_F4));
     actgoto->setShortcut(QKeySequence(Qt::Key_F5));
 
@@ -108,13 +115,26 @@ void BinaryView::analyze()
 {
     this->_datainspectormodel = new DataInspectorModel(ui->hexEdit);
     this->_templatemodel = new TemplateModel(ui->hexEdit);
+    this->_profilemodel = new ProfileModel(this);
+
+    this->_analysisscheduler = new AnalysisScheduler(ui->hexEdit->document(), this);
 
-    ui->chartTab->initialize(ui->hexEdit->document());
-    ui->stringsTab->initialize(ui->hexEdit->document());
-    ui->binaryNavigator->initialize(ui->hexEdit, this->_loadeddata);
+    ui->chartTab->initialize(ui->hexEdit->document(), this->_analysisscheduler);
+    ui->stringsTab->initialize(ui->hexEdit->document(), this->_analysisscheduler);
+    ui->binaryNavigator->initialize(ui->hexEdit, this->_analysisscheduler);
     ui->visualMap->initialize(ui->hexEdit);
     ui->dataInspector->setModel(this->_datainspectormodel);
     ui->tvTemplate->setModel(this->_templatemodel);
+    ui->tvProfile->setModel(this->_profilemodel);
+
+    connect(this->_templatemodel, &TemplateModel::executionStarted, [this]() { this->showTemplateProgress(true); });
+    connect(this->_templatemodel, &TemplateModel::executionFinished, [this]() { this->showTemplateProgress(false); });
+    connect(this->_templatemodel, &TemplateModel::progressChanged, this, &BinaryView::updateTemplateProgress);
+    connect(ui->tbAbortTemplate, &QToolButton::clicked, this->_templatemodel, &TemplateModel::abort);
+    connect(this->_templatemodel, &TemplateModel::resultChanged, [this]() { this->_profilemodel->setRecords(this->_templatemodel->profile()); });
+    this->showTemplateProgress(false);
+
+    this->_analysisscheduler->start(); /* One pass over the file feeds every registered consumer */
 }
 
 void BinaryView::saveTo(QFile *f)
@@ -130,12 +150,12 @@ void BinaryView::saveTo(QFile *f)
 
 void BinaryView::on_tvTemplate_clicked(const QModelIndex &index)
 {
-    if(!index.isValid() || !index.internalPointer())
+    integer_t offset = 0, size = 0;
+
+    if(!this->_templatemodel->range(index, &offset, &size))
         return;
 
-    QHexCursor* cursor = ui->hexEdit->document()->cursor();
-    BTEntry* btentry = reinterpret_cast<BTEntry*>(index.internalPointer());
-    cursor->setSelectionRange(btentry->location.offset, btentry->location.size);
+    ui->hexEdit->document()->cursor()->setSelectionRange(offset, size);
 }
 
 void BinaryView::updateStatus() const
@@ -162,11 +182,42 @@ void BinaryView::loadTemplate()
     if(file.isEmpty())
         return;
 
-    ui->hexEdit->document()->clearMetadata();
     this->_templatemodel->execute(file, ui->logWidget);
     ui->tabView->setCurrentIndex(2);
 }
 
+void BinaryView::exportTemplate()
+{
+    QString file = QFileDialog::getOpenFileName(this, tr("Template to export..."), QString(), "010 Editor Template (*.bt)");
+
+    if(file.isEmpty())
+        return;
+
+    QString exportfile = QFileDialog::getSaveFileName(this, tr("Export template output to..."), QString(), "PREF Columnar (*.prefcol)");
+
+    if(exportfile.isEmpty())
+        return;
+
+    this->_templatemodel->execute(file, ui->logWidget, exportfile);
+    ui->tabView->setCurrentIndex(2);
+}
+
+void BinaryView::updateTemplateProgress(integer_t covered, int entries)
+{
+    integer_t length = qMax(static_cast<integer_t>(1), this->_document->length());
+
+    ui->pbTemplate->setValue(static_cast<int>((qMin(covered, length) * 100) / length));
+    ui->pbTemplate->setFormat(tr("%1 entries, %p% covered").arg(entries));
+}
+
+void BinaryView::showTemplateProgress(bool b)
+{
+    ui->pbTemplate->setValue(0);
+    ui->pbTemplate->setFormat(tr("Running template..."));
+    ui->pbTemplate->setVisible(b);
+    ui->tbAbortTemplate->setVisible(b);
+}
+
 void BinaryView::showGoto()
 {
     integer_t offset = ScalarDialog::getScalar(this, tr("Goto..."), tr("Offset:"));
@@ -191,5 +242,8 @@ void BinaryView::saveAs()
 void BinaryView::save()
 {
     QFile f(this->loadedFile());
+
+    this->_mappedfile->unmap(); /* The file is rewritten in place, don't read it through a stale mapping */
     this->saveTo(&f);
+    this->_mappedfile->remap();
 }
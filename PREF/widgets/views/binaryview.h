@@ -3,9 +3,11 @@
 
 #include <QFile>
 #include "abstractview.h"
-#include "platform/loadeddata.h"
+#include "platform/mappedfile.h"
+#include "../../platform/analysis/analysisscheduler.h"
 #include "../../models/datainspectormodel.h"
 #include "../../models/templatemodel.h"
+#include "../../models/profilemodel.h"
 
 namespace Ui {
 class BinaryView;
@@ -29,15 +31,20 @@ class BinaryView : public AbstractView
         void on_tvTemplate_clicked(const QModelIndex &index);
         void updateStatus() const;
         void loadTemplate();
+        void exportTemplate();
+        void updateTemplateProgress(integer_t covered, int entries);
+        void showTemplateProgress(bool b);
         void showGoto();
         void saveAs();
         void save();
 
     private:
         Ui::BinaryView *ui;
-        LoadedData* _loadeddata;
+        MappedFile* _mappedfile;
+        AnalysisScheduler* _analysisscheduler;
         DataInspectorModel* _datainspectormodel;
         TemplateModel* _templatemodel;
+        ProfileModel* _profilemodel;
         QMenu *_menu, *_savemenu;
 };
 
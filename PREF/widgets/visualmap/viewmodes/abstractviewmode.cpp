@@ -1,21 +1,28 @@
 #include "abstractviewmode.h"
 #include <QPainter>
 
-AbstractViewMode::AbstractViewMode(QHexEdit *hexedit, QObject *parent): QObject(parent), _hexedit(hexedit), _width(256)
+AbstractViewMode::AbstractViewMode(QHexEdit *hexedit, QObject *parent): QObject(parent), _hexedit(hexedit)
 {
 
 }
 
-void AbstractViewMode::render(QPainter*, qint64 width)
+void AbstractViewMode::draw(QPainter *painter, const AbstractViewMode::Viewport &viewport)
 {
-    this->_width = width;
+    QMutexLocker locker(&this->_mutex);
+    this->render(painter, viewport);
 }
 
-qint64 AbstractViewMode::preferredHeight(const QPainter *painter)
+bool AbstractViewMode::usesSelection() const
 {
-    QPaintDevice* paintdevice = painter->device();
-    QHexMetrics* metrics = this->_hexedit->metrics();
+    return false;
+}
 
-    return qMin(static_cast<qint64>(metrics->document()->length() - metrics->visibleStartOffset()) / this->_width,
-                static_cast<qint64>(paintdevice->height()));
+int AbstractViewMode::variant() const
+{
+    return 0;
+}
+
+integer_t AbstractViewMode::lineSize(const Viewport &) const
+{
+    return 0; /* Rows don't map to consecutive data: the view is rendered whole */
 }
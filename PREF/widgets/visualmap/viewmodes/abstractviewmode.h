@@ -2,24 +2,40 @@
 #define ABSTRACTVIEWMODE_H
 
 #include <QObject>
+#include <QMutex>
+#include <QSize>
 #include <qhexedit/qhexedit.h>
 
 class AbstractViewMode : public QObject
 {
     Q_OBJECT
 
+    public:
+        struct Viewport /* Snapshot taken in the GUI thread: rendering never looks at the hex view */
+        {
+            integer_t Offset;          /* First visible byte */
+            integer_t SelectionStart;
+            integer_t SelectionEnd;
+            qint64 Width;
+            QSize Size;
+            int Variant;               /* variant() at request time: settings may change before rendering */
+        };
+
     public:
         explicit AbstractViewMode(QHexEdit* hexedit, QObject *parent = 0);
+        void draw(QPainter* painter, const Viewport& viewport);
         virtual integer_t size() const = 0;
-        virtual integer_t offset(const QPoint &p) const = 0;
-        virtual void render(QPainter*, qint64 width);
+        virtual integer_t offset(const QPoint &p, const Viewport& viewport) const = 0;
+        virtual bool usesSelection() const;
+        virtual int variant() const;
+        virtual integer_t lineSize(const Viewport& viewport) const;
 
     protected:
-        virtual qint64 preferredHeight(const QPainter *painter);
+        virtual void render(QPainter* painter, const Viewport& viewport) = 0;
 
     protected:
         QHexEdit* _hexedit;
-        qint64 _width;
+        QMutex _mutex; /* Held while rendering: settings change between two images */
 };
 
 #endif // ABSTRACTVIEWMODE_H
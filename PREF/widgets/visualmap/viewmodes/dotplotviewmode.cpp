@@ -1,9 +1,22 @@
 #include "dotplotviewmode.h"
 #include <qhexedit/qhexedit.h>
 #include <QPainter>
+#include <QtAlgorithms>
 
-DotPlotViewMode::DotPlotViewMode(QHexEdit *hexedit, QObject *parent): AbstractViewMode(hexedit, parent)
+const integer_t DotPlotViewMode::TILE_SIZE = 256; /* Multiple of 64: a row of columns is a handful of words */
+const integer_t DotPlotViewMode::MIN_PLOT_SIZE = 500;
+const integer_t DotPlotViewMode::MAX_PLOT_SIZE = 4096;
+const int DotPlotViewMode::CACHE_SIZE = 0x4000000; /* Bytes */
+
+DotPlotViewMode::DotPlotViewMode(QHexEdit *hexedit, QObject *parent): AbstractViewMode(hexedit, parent), _tiles(DotPlotViewMode::CACHE_SIZE), _generation(0)
 {
+    for(int i = 0; i < 256; i++) /* Intensities start at 64: below that only black is used */
+    {
+        this->_colortable.append((i < 64) ? qRgb(0, 0, 0) : qRgb(0, i, 0));
+        this->_selectedcolortable.append((i < 64) ? qRgb(0, 0, 0) : qRgb(i, i, 0));
+    }
+
+    connect(hexedit->document(), &QHexDocument::documentChanged, this, &DotPlotViewMode::invalidate);
 }
 
 integer_t DotPlotViewMode::size() const
@@ -11,53 +24,143 @@ integer_t DotPlotViewMode::size() const
     return this->_hexedit->document()->length();
 }
 
-integer_t DotPlotViewMode::offset(const QPoint &p) const
+integer_t DotPlotViewMode::offset(const QPoint &p, const Viewport &viewport) const
 {
     integer_t l = this->_hexedit->document()->length();
-    integer_t s = qMin(integer_t(500), l);
-    QHexMetrics* metrics = this->_hexedit->metrics();
-    return qMin(metrics->visibleStartOffset() + (p.x() + (p.y() / s)), l);
+    integer_t s = qMax(qMin(DotPlotViewMode::plotSize(viewport), l), static_cast<integer_t>(1));
+    return qMin(viewport.Offset + (p.x() + (p.y() / s)), l);
+}
+
+bool DotPlotViewMode::usesSelection() const
+{
+    return true;
+}
+
+integer_t DotPlotViewMode::plotSize(const Viewport &viewport)
+{
+    return qBound(DotPlotViewMode::MIN_PLOT_SIZE, static_cast<integer_t>(qMin(viewport.Size.width(), viewport.Size.height())), DotPlotViewMode::MAX_PLOT_SIZE);
 }
 
-void DotPlotViewMode::render(QPainter *painter, qint64 width)
+uchar DotPlotViewMode::matchLevel(uchar b)
 {
-    AbstractViewMode::render(painter, width);
+    return static_cast<uchar>((static_cast<qreal>(b) * 0.75) + 64);
+}
 
-    QHexMetrics* metrics = this->_hexedit->metrics();
+void DotPlotViewMode::render(QPainter *painter, const Viewport &viewport)
+{
     QHexDocument* document = this->_hexedit->document();
-    QHexCursor* cursor = document->cursor();
-    integer_t s = std::min(integer_t(500), document->length()), start = metrics->visibleStartOffset();
+    integer_t start = viewport.Offset;
+    integer_t end = qMin(start + DotPlotViewMode::plotSize(viewport), document->length());
 
-    QImage img(s, s, QImage::Format_RGB888);
-    img.fill(QColor(Qt::black));
+    if(end <= start)
+        return;
 
-    for(integer_t i = 0; i < s; i++)
-    {
-        if((start + i) >= document->length())
-            break;
+    integer_t firsttile = start / DotPlotViewMode::TILE_SIZE, lasttile = (end - 1) / DotPlotViewMode::TILE_SIZE;
+    integer_t dataoffset = firsttile * DotPlotViewMode::TILE_SIZE;
+    int generation = this->_generation.load();
+    QByteArray data;
 
-        uchar ib = document->at(start + i);
+    painter->save();
+    painter->setClipRect(0, 0, static_cast<int>(end - start), static_cast<int>(end - start));
 
-        for(integer_t j = 0; j < s; j++)
+    for(integer_t row = firsttile; row <= lasttile; row++)
+    {
+        for(integer_t column = firsttile; column <= lasttile; column++)
         {
-            integer_t offset = start + j;
+            TileKey key = qMakePair(row, column);
+            QImage tile;
 
-            if(offset >= document->length())
-                break;
+            {
+                QMutexLocker locker(&this->_tilesmutex);
+                QImage* cached = this->_tiles.object(key);
 
-            uchar jb = document->at(offset);
+                if(cached)
+                    tile = *cached; /* Implicitly shared: stays valid when the cache evicts it */
+            }
 
-            if(jb == ib)
+            if(tile.isNull())
             {
-                uchar b = static_cast<uchar>((static_cast<qreal>(jb) * 0.75) + 64);
+                if(data.isEmpty()) /* The whole window is read once, and only when a tile is missing */
+                    data = document->read(dataoffset, ((lasttile + 1) * DotPlotViewMode::TILE_SIZE) - dataoffset);
+
+                integer_t rowstart = (row * DotPlotViewMode::TILE_SIZE) - dataoffset, columnstart = (column * DotPlotViewMode::TILE_SIZE) - dataoffset;
+                integer_t datasize = static_cast<integer_t>(data.size());
+                const uchar* p = reinterpret_cast<const uchar*>(data.constData());
+
+                tile = this->renderTile(p + rowstart, qMin(DotPlotViewMode::TILE_SIZE, datasize - qMin(rowstart, datasize)),
+                                        p + columnstart, qMin(DotPlotViewMode::TILE_SIZE, datasize - qMin(columnstart, datasize)));
 
-                if((offset >= cursor->selectionStart()) && (offset <= cursor->selectionEnd()))
-                    img.setPixel(j, i, qRgb(b, b, 0));
-                else
-                    img.setPixel(j, i, qRgb(0, b, 0));
+                QMutexLocker locker(&this->_tilesmutex);
+
+                if(this->_generation.load() == generation) /* Built from data edited since: drawn, never reused */
+                    this->_tiles.insert(key, new QImage(tile), static_cast<int>(tile.sizeInBytes()));
             }
+
+            QPoint pos(static_cast<int>(static_cast<sinteger_t>(column * DotPlotViewMode::TILE_SIZE) - static_cast<sinteger_t>(start)),
+                       static_cast<int>(static_cast<sinteger_t>(row * DotPlotViewMode::TILE_SIZE) - static_cast<sinteger_t>(start)));
+
+            painter->drawImage(pos, tile);
+            this->drawSelection(painter, tile, pos, column, viewport);
         }
     }
 
-    painter->drawImage(0, 0, img);
+    painter->restore();
+}
+
+QImage DotPlotViewMode::renderTile(const uchar *rowdata, integer_t rowcount, const uchar *columndata, integer_t columncount) const
+{
+    const integer_t words = DotPlotViewMode::TILE_SIZE / 64;
+    QImage image(DotPlotViewMode::TILE_SIZE, DotPlotViewMode::TILE_SIZE, QImage::Format_Indexed8);
+    QVector<quint64> masks(256 * words, 0); /* Byte value -> Columns holding it */
+
+    image.setColorTable(this->_colortable);
+    image.fill(0);
+
+    for(integer_t j = 0; j < columncount; j++)
+        masks[(columndata[j] * words) + (j / 64)] |= Q_UINT64_C(1) << (j % 64);
+
+    for(integer_t i = 0; i < rowcount; i++)
+    {
+        const quint64* mask = masks.constData() + (rowdata[i] * words);
+        uchar* line = image.scanLine(static_cast<int>(i));
+        uchar level = DotPlotViewMode::matchLevel(rowdata[i]); /* Every match in a row has the row's value */
+
+        for(integer_t w = 0; w < words; w++)
+        {
+            quint64 bits = mask[w];
+
+            while(bits)
+            {
+                line[(w * 64) + qCountTrailingZeroBits(bits)] = level;
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    return image;
+}
+
+void DotPlotViewMode::drawSelection(QPainter *painter, const QImage &tile, const QPoint &pos, integer_t column, const Viewport &viewport) const
+{
+    integer_t tilestart = column * DotPlotViewMode::TILE_SIZE, tileend = tilestart + DotPlotViewMode::TILE_SIZE - 1;
+    integer_t selectionstart = qMax(viewport.SelectionStart, tilestart);
+    integer_t selectionend = qMin(viewport.SelectionEnd, tileend);
+
+    if(selectionstart > selectionend)
+        return;
+
+    /* Matches are already there: the selected columns are only drawn again with another palette */
+    QRect r(static_cast<int>(selectionstart - tilestart), 0, static_cast<int>(selectionend - selectionstart + 1), tile.height());
+    QImage selection = tile.copy(r);
+    selection.setColorTable(this->_selectedcolortable);
+
+    painter->drawImage(pos + r.topLeft(), selection);
+}
+
+void DotPlotViewMode::invalidate()
+{
+    /* The render mutex may be held for a whole plot: edits only wait for the cache */
+    QMutexLocker locker(&this->_tilesmutex);
+    this->_generation.ref();
+    this->_tiles.clear();
 }
@@ -1,20 +1,47 @@
 #ifndef DOTPLOTVIEWMODE_H
 #define DOTPLOTVIEWMODE_H
 
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QAtomicInt>
 #include "abstractviewmode.h"
 
 class DotPlotViewMode : public AbstractViewMode
 {
     Q_OBJECT
 
-    public:
-        explicit DotPlotViewMode(QHexEdit* hexedit, QObject *parent = 0);
+    private:
+        typedef QPair<integer_t, integer_t> TileKey; /* Row and column tile, at absolute file positions: scrolling reuses them */
 
     public:
-        explicit DotPlotViewMode(QObject *parent = 0);
+        explicit DotPlotViewMode(QHexEdit* hexedit, QObject *parent = 0);
         virtual integer_t size() const;
-        virtual integer_t offset(const QPoint &p) const;
-        virtual void render(QPainter* painter, qint64 width);
+        virtual integer_t offset(const QPoint &p, const Viewport& viewport) const;
+        virtual bool usesSelection() const;
+
+    protected:
+        virtual void render(QPainter* painter, const Viewport& viewport);
+
+    private:
+        static integer_t plotSize(const Viewport& viewport);
+        static inline uchar matchLevel(uchar b);
+        QImage renderTile(const uchar* rowdata, integer_t rowcount, const uchar* columndata, integer_t columncount) const;
+        void drawSelection(QPainter* painter, const QImage& tile, const QPoint& pos, integer_t column, const Viewport& viewport) const;
+
+    private slots:
+        void invalidate();
+
+    private:
+        static const integer_t TILE_SIZE;
+        static const integer_t MIN_PLOT_SIZE;
+        static const integer_t MAX_PLOT_SIZE;
+        static const int CACHE_SIZE;
+        QCache<TileKey, QImage> _tiles;
+        QMutex _tilesmutex;     /* Only held around cache lookups and updates, never while rendering */
+        QAtomicInt _generation; /* Bumped on edits: tiles rendered before one are never cached */
+        QVector<QRgb> _colortable;         /* Indexed by match intensity, 0 is no match */
+        QVector<QRgb> _selectedcolortable;
 };
 
 #endif // DOTPLOTVIEWMODE_H
@@ -1,12 +1,46 @@
 #include "pixelviewmode.h"
+#include "../../../platform/mappedfile.h"
 #include <qhexedit/qhexedit.h>
 #include <support/bytecolors.h>
 #include <QPainter>
+#include <cstring>
 
 using namespace PrefLib::Support;
 
-PixelViewMode::PixelViewMode(QHexEdit *hexedit, QObject *parent): AbstractViewMode(hexedit, parent)
+PixelViewMode::PixelViewMode(QHexEdit *hexedit, QObject *parent): AbstractViewMode(hexedit, parent), _format(PixelViewMode::Category)
 {
+    for(int i = 0; i < 256; i++)
+    {
+        this->_categorytable.append(QColor(ByteColors::info(i).Color).rgb());
+        this->_heattable.append(QColor::fromRgb(ByteColors::entropyColor(i / 255.0)).rgb());
+    }
+}
+
+PixelViewMode::Format PixelViewMode::format() const
+{
+    return this->_format;
+}
+
+void PixelViewMode::setFormat(PixelViewMode::Format format)
+{
+    QMutexLocker locker(&this->_mutex);
+    this->_format = format;
+}
+
+QString PixelViewMode::formatName(PixelViewMode::Format format)
+{
+    if(format == PixelViewMode::Category)
+        return tr("Byte Categories");
+    else if(format == PixelViewMode::Heat)
+        return tr("Byte Values (Heat)");
+    else if(format == PixelViewMode::Rgb888)
+        return tr("RGB (24 bit)");
+    else if(format == PixelViewMode::Rgba8888)
+        return tr("RGBA (32 bit)");
+    else if(format == PixelViewMode::Grayscale16)
+        return tr("Grayscale (16 bit)");
+
+    return QString();
 }
 
 integer_t PixelViewMode::size() const
@@ -15,26 +49,135 @@ integer_t PixelViewMode::size() const
     return metrics->document()->length() - metrics->visibleStartOffset();
 }
 
-integer_t PixelViewMode::offset(const QPoint &p) const
+integer_t PixelViewMode::offset(const QPoint &p, const Viewport &viewport) const
 {
-    QHexMetrics* metrics = this->_hexedit->metrics();
-    return metrics->visibleStartOffset() + (p.x() + (p.y() * this->_width));
+    return viewport.Offset + ((p.x() + (p.y() * viewport.Width)) * PixelViewMode::bytesPerPixel(static_cast<Format>(viewport.Variant)));
 }
 
-void PixelViewMode::render(QPainter *painter, qint64 width)
+int PixelViewMode::variant() const
 {
-    AbstractViewMode::render(painter, width);
+    return this->_format;
+}
 
-    QHexMetrics* metrics = this->_hexedit->metrics();
+integer_t PixelViewMode::lineSize(const Viewport &viewport) const
+{
+    if(viewport.Width <= 0)
+        return 0;
+
+    return viewport.Width * PixelViewMode::bytesPerPixel(static_cast<Format>(viewport.Variant));
+}
+
+void PixelViewMode::render(QPainter *painter, const Viewport &viewport)
+{
+    if(viewport.Width <= 0)
+        return;
+
+    Format format = static_cast<Format>(viewport.Variant); /* What the image is keyed with, not the current format */
     QHexDocument* document = this->_hexedit->document();
-    qint64 s = metrics->visibleStartOffset(), h = this->preferredHeight(painter), e = std::min(document->length(), static_cast<integer_t>(this->_width * h));
+    integer_t start = viewport.Offset;
+    integer_t bytesperline = viewport.Width * PixelViewMode::bytesPerPixel(format);
+
+    if(start >= document->length())
+        return;
+
+    /* Whole lines only */
+    int height = static_cast<int>(qMin((document->length() - start) / bytesperline, static_cast<integer_t>(viewport.Size.height())));
+
+    if(height <= 0)
+        return;
+
+    MappedFile* mappedfile = MappedFile::fromDocument(document);
+    const uchar* data = mappedfile ? mappedfile->acquire(start, bytesperline * height) : NULL;
+
+    if(!data)
+    {
+        this->drawCopied(painter, start, static_cast<int>(viewport.Width), height, format);
+        return;
+    }
+
+    this->drawMapped(painter, data, static_cast<int>(viewport.Width), height, format);
+    mappedfile->release();
+}
+
+integer_t PixelViewMode::bytesPerPixel(Format format)
+{
+    if(format == PixelViewMode::Rgb888)
+        return 3;
+    else if(format == PixelViewMode::Rgba8888)
+        return 4;
+    else if(format == PixelViewMode::Grayscale16)
+        return 2;
 
-    if(s > e)
-        e = document->length();
+    return 1;
+}
 
-    this->_bits = document->read(s, e - s);
+QImage::Format PixelViewMode::imageFormat(Format format)
+{
+    if(format == PixelViewMode::Rgb888)
+        return QImage::Format_RGB888;
+    else if(format == PixelViewMode::Rgba8888)
+        return QImage::Format_RGBA8888;
+    else if(format == PixelViewMode::Grayscale16) /* Host byte order */
+        return QImage::Format_Grayscale16;
+
+    return QImage::Format_RGB32; /* Palettes are resolved while filling the image */
+}
+
+const QVector<QRgb>* PixelViewMode::colorTable(Format format) const
+{
+    if(format == PixelViewMode::Category)
+        return &this->_categorytable;
+    else if(format == PixelViewMode::Heat)
+        return &this->_heattable;
+
+    return NULL;
+}
+
+void PixelViewMode::fillImage(const uchar *data, int width, int height, Format format)
+{
+    if((this->_image.width() != width) || (this->_image.height() != height) || (this->_image.format() != PixelViewMode::imageFormat(format)))
+        this->_image = QImage(width, height, PixelViewMode::imageFormat(format));
 
-    QImage img(reinterpret_cast<const uchar*>(this->_bits.constData()), this->_width, h, this->_width, QImage::Format_Indexed8);
-    //FIXME: img.setColorTable(ByteColors::colorTable());
+    const QVector<QRgb>* colortable = this->colorTable(format);
+    int bytesperline = width * static_cast<int>(PixelViewMode::bytesPerPixel(format));
+
+    for(int i = 0; i < height; i++)
+    {
+        const uchar* source = data + (i * bytesperline);
+
+        if(!colortable) /* Image lines are padded to 32 bits */
+        {
+            std::memcpy(this->_image.scanLine(i), source, bytesperline);
+            continue;
+        }
+
+        QRgb* line = reinterpret_cast<QRgb*>(this->_image.scanLine(i));
+        const QRgb* colors = colortable->constData();
+
+        for(int j = 0; j < width; j++)
+            line[j] = colors[source[j]];
+    }
+}
+
+void PixelViewMode::drawMapped(QPainter *painter, const uchar *data, int width, int height, Format format)
+{
+    if(this->colorTable(format)) /* A palette on a read-only image would detach (and copy) it: resolve colors in one pass instead */
+    {
+        this->fillImage(data, width, height, format);
+        painter->drawImage(0, 0, this->_image);
+        return;
+    }
+
+    /* Scanlines are read straight from the mapping: the image never owns (nor copies) them */
+    QImage img(data, width, height, width * static_cast<int>(PixelViewMode::bytesPerPixel(format)), PixelViewMode::imageFormat(format));
     painter->drawImage(0, 0, img);
 }
+
+void PixelViewMode::drawCopied(QPainter *painter, integer_t offset, int width, int height, Format format)
+{
+    int bytesperline = width * static_cast<int>(PixelViewMode::bytesPerPixel(format));
+    QByteArray data = this->_hexedit->document()->read(offset, bytesperline * height); /* Modified ranges aren't mapped */
+
+    this->fillImage(reinterpret_cast<const uchar*>(data.constData()), width, height, format);
+    painter->drawImage(0, 0, this->_image);
+}
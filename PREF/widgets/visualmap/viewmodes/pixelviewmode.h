@@ -1,22 +1,44 @@
 #ifndef PIXELVIEWMODE_H
 #define PIXELVIEWMODE_H
 
+#include <QImage>
 #include "abstractviewmode.h"
 
 class PixelViewMode : public AbstractViewMode
 {
     Q_OBJECT
 
+    public:
+        enum Format { Category, Heat, Rgb888, Rgba8888, Grayscale16, FormatCount };
+
     public:
         explicit PixelViewMode(QHexEdit *hexedit, QObject *parent = 0);
+        Format format() const;
+        void setFormat(Format format);
+        static QString formatName(Format format);
 
     public: /* Overriden Methods */
         virtual integer_t size() const;
-        virtual integer_t offset(const QPoint &p) const;
-        virtual void render(QPainter* painter, qint64 width);
+        virtual integer_t offset(const QPoint &p, const Viewport& viewport) const;
+        virtual int variant() const;
+        virtual integer_t lineSize(const Viewport& viewport) const;
+
+    protected:
+        virtual void render(QPainter* painter, const Viewport& viewport);
+
+    private:
+        static integer_t bytesPerPixel(Format format);
+        static QImage::Format imageFormat(Format format);
+        const QVector<QRgb>* colorTable(Format format) const;
+        void fillImage(const uchar* data, int width, int height, Format format);
+        void drawMapped(QPainter* painter, const uchar* data, int width, int height, Format format);
+        void drawCopied(QPainter* painter, integer_t offset, int width, int height, Format format);
 
     private:
-        QByteArray _bits;
+        Format _format;
+        QVector<QRgb> _categorytable;
+        QVector<QRgb> _heattable;
+        QImage _image; /* Reused while width, height and image format don't change */
 };
 
 #endif // PIXELVIEWMODE_H
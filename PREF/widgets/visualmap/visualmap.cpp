@@ -2,10 +2,13 @@
 #include <QGuiApplication>
 #include <QMouseEvent>
 #include <QPainter>
+#include <QMenu>
 
 const QString VisualMap::NO_DATA_AVAILABLE = "No Data Available";
+const int VisualMap::CACHE_SIZE = 0x8000; /* KB */
+const integer_t VisualMap::BAND_HEIGHT = 64; /* Rows */
 
-VisualMap::VisualMap(QWidget *parent): QWidget(parent), _viewmode(VisualMap::DotPlot), _hexedit(NULL), _step(0), _width(256)
+VisualMap::VisualMap(QWidget *parent): QWidget(parent), _viewmode(VisualMap::DotPlot), _hexedit(NULL), _step(0), _width(256), _renderer(NULL), _tiles(VisualMap::CACHE_SIZE), _generation(0)
 {
     QFont f("Monospace", qApp->font().pointSize());
     f.setStyleHint(QFont::TypeWriter);
@@ -21,6 +24,15 @@ VisualMap::VisualMap(QWidget *parent): QWidget(parent), _viewmode(VisualMap::Dot
     this->setPalette(p);
 }
 
+VisualMap::~VisualMap()
+{
+    if(this->_renderer)
+    {
+        this->_renderer->abort();
+        this->_renderer->wait();
+    }
+}
+
 void VisualMap::setWidth(qint64 w)
 {
     if(w < 0)
@@ -42,16 +54,67 @@ void VisualMap::setDisplayMode(VisualMap::DisplayMode mode)
 
 void VisualMap::initialize(QHexEdit* hexedit)
 {
+    if(this->_renderer)
+    {
+        this->_renderer->abort();
+        this->_renderer->wait();
+        this->_renderer->deleteLater();
+    }
+
     this->_hexedit = hexedit;
     this->populateViewModes();
+    this->invalidate();
+
+    this->_renderer = new VisualMapRenderer(hexedit->document(), this);
+    connect(this->_renderer, &VisualMapRenderer::rendered, this, &VisualMap::imageRendered);
+    this->_renderer->start(QThread::LowPriority);
 
-    connect(this->_hexedit, &QHexEdit::verticalScroll, [this](integer_t) { this->update(); });
-    connect(this->_hexedit->document()->cursor(), &QHexCursor::selectionChanged, [this]() { this->update(); });
+    connect(this->_hexedit->document(), &QHexDocument::documentChanged, this, &VisualMap::invalidate);
+    connect(this->_hexedit, &QHexEdit::verticalScroll, this, [this](integer_t) { this->update(); });
+    connect(this->_hexedit->document()->cursor(), &QHexCursor::selectionChanged, this, [this]() { this->update(); });
 }
 
 qint64 VisualMap::calcOffset(const QPoint &cursorpos)
 {
-    return this->_viewmodes[this->_viewmode]->offset(QPoint(cursorpos));
+    return this->_viewmodes[this->_viewmode]->offset(QPoint(cursorpos), this->currentViewport());
+}
+
+AbstractViewMode::Viewport VisualMap::currentViewport() const
+{
+    QHexCursor* cursor = this->_hexedit->document()->cursor();
+    AbstractViewMode::Viewport viewport;
+
+    viewport.Offset = this->_hexedit->metrics()->visibleStartOffset();
+    viewport.SelectionStart = cursor->selectionStart();
+    viewport.SelectionEnd = cursor->selectionEnd();
+    viewport.Width = this->_width;
+    viewport.Size = this->size();
+    viewport.Variant = this->_viewmodes[this->_viewmode]->variant();
+
+    integer_t linesize = this->_viewmodes[this->_viewmode]->lineSize(viewport);
+
+    if(linesize) /* Rows sit at absolute positions: bands are reused while scrolling */
+        viewport.Offset -= viewport.Offset % linesize;
+
+    return viewport;
+}
+
+QString VisualMap::tileKey(const AbstractViewMode::Viewport &viewport) const
+{
+    AbstractViewMode* viewmode = this->_viewmodes[this->_viewmode];
+
+    QString key = QString("%1:%2:%3:%4:%5:%6x%7").arg(this->_generation)
+                                                 .arg(this->_viewmode)
+                                                 .arg(viewport.Variant)
+                                                 .arg(viewport.Offset)
+                                                 .arg(viewport.Width)
+                                                 .arg(viewport.Size.width())
+                                                 .arg(viewport.Size.height());
+
+    if(viewmode->usesSelection()) /* Other modes don't need to be rendered again when the selection changes */
+        key += QString(":%1-%2").arg(viewport.SelectionStart).arg(viewport.SelectionEnd);
+
+    return key;
 }
 
 void VisualMap::populateViewModes()
@@ -69,6 +132,25 @@ void VisualMap::drawNoDataAvailable(QPainter &p)
     p.drawText(10, 10, fm.width(VisualMap::NO_DATA_AVAILABLE), fm.height(), Qt::AlignLeft | Qt::AlignTop, VisualMap::NO_DATA_AVAILABLE);
 }
 
+void VisualMap::imageRendered(const QString &key, const QImage &image)
+{
+    if(!key.startsWith(QString::number(this->_generation) + ":")) /* Rendered before an edit */
+        return;
+
+    this->_tiles.insert(key, new QImage(image), qMax(static_cast<int>(image.sizeInBytes() / 1024), 1));
+
+    if(this->_hexedit) /* Painting only composes cached images */
+        this->update();
+}
+
+void VisualMap::invalidate()
+{
+    this->_generation++;
+    this->_tiles.clear();
+    this->_lastimage = QImage();
+    this->update();
+}
+
 void VisualMap::mousePressEvent(QMouseEvent *event)
 {
     if(this->_hexedit && (event->buttons() == Qt::LeftButton))
@@ -93,6 +175,36 @@ void VisualMap::wheelEvent(QWheelEvent *event)
     QWidget::wheelEvent(event);
 }
 
+void VisualMap::contextMenuEvent(QContextMenuEvent *event)
+{
+    if(!this->_hexedit)
+        return;
+
+    PixelViewMode* pixelviewmode = static_cast<PixelViewMode*>(this->_viewmodes[VisualMap::BytesAsPixel]);
+    QMenu menu(this);
+
+    QAction* actdotplot = menu.addAction(tr("Dot Plot"), [this]() { this->setDisplayMode(VisualMap::DotPlot); });
+    actdotplot->setCheckable(true);
+    actdotplot->setChecked(this->_viewmode == VisualMap::DotPlot);
+
+    QMenu* pixelmenu = menu.addMenu(tr("Bytes as Pixels"));
+
+    for(int i = 0; i < PixelViewMode::FormatCount; i++)
+    {
+        PixelViewMode::Format format = static_cast<PixelViewMode::Format>(i);
+
+        QAction* action = pixelmenu->addAction(PixelViewMode::formatName(format), [this, pixelviewmode, format]() {
+            pixelviewmode->setFormat(format);
+            this->setDisplayMode(VisualMap::BytesAsPixel);
+        });
+
+        action->setCheckable(true);
+        action->setChecked((this->_viewmode == VisualMap::BytesAsPixel) && (pixelviewmode->format() == format));
+    }
+
+    menu.exec(event->globalPos());
+}
+
 void VisualMap::paintEvent(QPaintEvent *)
 {
     if(!this->_viewmodes.contains(this->_viewmode) || this->_width == -1)
@@ -106,5 +218,67 @@ void VisualMap::paintEvent(QPaintEvent *)
         return;
     }
 
-    this->_viewmodes[this->_viewmode]->render(&p, this->_width);
+    AbstractViewMode* viewmode = this->_viewmodes[this->_viewmode];
+    AbstractViewMode::Viewport viewport = this->currentViewport();
+    integer_t linesize = viewmode->lineSize(viewport);
+
+    if(linesize)
+        this->drawBands(p, viewmode, viewport, linesize);
+    else
+        this->drawWhole(p, viewmode, viewport);
+}
+
+void VisualMap::drawWhole(QPainter &p, AbstractViewMode *viewmode, const AbstractViewMode::Viewport &viewport)
+{
+    QString key = this->tileKey(viewport);
+    QImage* image = this->_tiles.object(key);
+
+    if(image)
+    {
+        this->_lastimage = *image;
+        p.drawImage(0, 0, *image);
+        return;
+    }
+
+    if(!this->_lastimage.isNull()) /* Keep the previous image until the new one is ready */
+        p.drawImage(0, 0, this->_lastimage);
+
+    VisualMapRenderer::Request request = { viewmode, viewport, key };
+    this->_renderer->request(VisualMapRenderer::RequestList() << request);
+}
+
+void VisualMap::drawBands(QPainter &p, AbstractViewMode *viewmode, const AbstractViewMode::Viewport &viewport, integer_t linesize)
+{
+    /* Fixed height bands at aligned offsets: scrolling renders only the bands coming into view */
+    integer_t length = this->_hexedit->document()->length();
+    integer_t firstrow = viewport.Offset / linesize;
+    integer_t firstband = firstrow / VisualMap::BAND_HEIGHT;
+    integer_t lastband = (firstrow + qMax(viewport.Size.height(), 1) - 1) / VisualMap::BAND_HEIGHT;
+    VisualMapRenderer::RequestList requests;
+
+    this->_lastimage = QImage();
+
+    for(integer_t band = firstband; band <= lastband; band++)
+    {
+        AbstractViewMode::Viewport bandviewport = viewport;
+        bandviewport.Offset = band * VisualMap::BAND_HEIGHT * linesize;
+        bandviewport.Size.setHeight(static_cast<int>(VisualMap::BAND_HEIGHT));
+
+        if(bandviewport.Offset >= length)
+            break;
+
+        QString key = this->tileKey(bandviewport);
+        QImage* image = this->_tiles.object(key);
+
+        if(!image)
+        {
+            VisualMapRenderer::Request request = { viewmode, bandviewport, key };
+            requests.append(request);
+            continue;
+        }
+
+        p.drawImage(0, static_cast<int>(static_cast<sinteger_t>(band * VisualMap::BAND_HEIGHT) - static_cast<sinteger_t>(firstrow)), *image);
+    }
+
+    this->_renderer->request(requests); /* Also drops bands requested for views scrolled past */
 }
@@ -2,8 +2,10 @@
 #define VISUALMAP_H
 
 #include <QWidget>
+#include <QCache>
 #include "viewmodes/dotplotviewmode.h"
 #include "viewmodes/pixelviewmode.h"
+#include "visualmaprenderer.h"
 
 class VisualMap : public QWidget
 {
@@ -17,6 +19,7 @@ class VisualMap : public QWidget
 
     public:
         explicit VisualMap(QWidget *parent = 0);
+        ~VisualMap();
 
     public slots:
         void setWidth(qint64 w);
@@ -25,12 +28,21 @@ class VisualMap : public QWidget
 
     private:
         qint64 calcOffset(const QPoint &cursorpos);
+        AbstractViewMode::Viewport currentViewport() const;
+        QString tileKey(const AbstractViewMode::Viewport& viewport) const;
         void populateViewModes();
         void drawNoDataAvailable(QPainter& p);
+        void drawWhole(QPainter& p, AbstractViewMode* viewmode, const AbstractViewMode::Viewport& viewport);
+        void drawBands(QPainter& p, AbstractViewMode* viewmode, const AbstractViewMode::Viewport& viewport, integer_t linesize);
+
+    private slots:
+        void imageRendered(const QString& key, const QImage& image);
+        void invalidate();
 
     protected:
         virtual void mousePressEvent(QMouseEvent* event);
         virtual void wheelEvent(QWheelEvent* event);
+        virtual void contextMenuEvent(QContextMenuEvent* event);
         virtual void paintEvent(QPaintEvent*);
 
     signals:
@@ -38,11 +50,17 @@ class VisualMap : public QWidget
 
     private:
         static const QString NO_DATA_AVAILABLE;
+        static const int CACHE_SIZE;
+        static const integer_t BAND_HEIGHT;
         ViewMode _viewmodes;
         DisplayMode _viewmode;
         QHexEdit* _hexedit;
         qint64 _step;
         qint64 _width;
+        VisualMapRenderer* _renderer;
+        QCache<QString, QImage> _tiles; /* View state -> Rendered image (a band of rows, or the whole view) */
+        QImage _lastimage;              /* Painted while a whole view is being rendered */
+        int _generation;                /* Bumped on edits: images rendered before them are discarded */
 
     friend class BinaryViewPage;
     friend class BinaryViewDialog;
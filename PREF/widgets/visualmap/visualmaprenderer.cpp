@@ -0,0 +1,63 @@
+#include "visualmaprenderer.h"
+#include <QPainter>
+
+VisualMapRenderer::VisualMapRenderer(QHexDocument *document, QObject *parent): BasicWorker(document, parent)
+{
+
+}
+
+void VisualMapRenderer::request(const RequestList &requests)
+{
+    QMutexLocker locker(&this->_mutex);
+
+    /* Only the latest view is kept: views scrolled past are never rendered */
+    this->_requests.clear();
+
+    foreach(const Request& request, requests)
+    {
+        if(request.Key != this->_renderingkey) /* Already on its way */
+            this->_requests.append(request);
+    }
+
+    this->_wakeup.wakeOne();
+}
+
+void VisualMapRenderer::abort()
+{
+    QMutexLocker locker(&this->_mutex);
+
+    BasicWorker::abort();
+    this->_wakeup.wakeOne();
+}
+
+void VisualMapRenderer::run()
+{
+    forever
+    {
+        Request request;
+
+        {
+            QMutexLocker locker(&this->_mutex);
+
+            this->_renderingkey.clear();
+
+            while(this->_cancontinue && this->_requests.isEmpty())
+                this->_wakeup.wait(&this->_mutex);
+
+            if(!this->_cancontinue)
+                return;
+
+            request = this->_requests.takeFirst();
+            this->_renderingkey = request.Key;
+        }
+
+        QImage image(request.Viewport.Size, QImage::Format_RGB32);
+        image.fill(Qt::black);
+
+        QPainter painter(&image);
+        request.ViewMode->draw(&painter, request.Viewport);
+        painter.end();
+
+        emit rendered(request.Key, image);
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef VISUALMAPRENDERER_H
+#define VISUALMAPRENDERER_H
+
+#include <QImage>
+#include <QMutex>
+#include <QWaitCondition>
+#include "../../platform/basicworker.h"
+#include "viewmodes/abstractviewmode.h"
+
+class VisualMapRenderer : public BasicWorker
+{
+    Q_OBJECT
+
+    public:
+        struct Request
+        {
+            AbstractViewMode* ViewMode;
+            AbstractViewMode::Viewport Viewport;
+            QString Key;
+        };
+
+        typedef QList<Request> RequestList;
+
+    public:
+        explicit VisualMapRenderer(QHexDocument *document, QObject *parent = 0);
+        void request(const RequestList& requests);
+
+    public slots:
+        virtual void abort();
+
+    protected:
+        virtual void run();
+
+    signals:
+        void rendered(const QString& key, const QImage& image);
+
+    private:
+        RequestList _requests;
+        QString _renderingkey;
+        QMutex _mutex;
+        QWaitCondition _wakeup;
+};
+
+#endif // VISUALMAPRENDERER_H
@@ -0,0 +1,6 @@
+TEMPLATE = subdirs
+
+bytecounter.file = bytecounter/bytecounter.pro
+templatemodel.file = templatemodel/templatemodel.pro
+
+SUBDIRS = bytecounter templatemodel
@@ -0,0 +1,18 @@
+#-------------------------------------------------
+#
+# Byte counting throughput, run it in release mode
+#
+#-------------------------------------------------
+
+CONFIG   += console
+CONFIG   -= app_bundle qt
+
+TARGET = bytecounter_bench
+TEMPLATE = app
+
+INCLUDEPATH += $$PWD/../../PREF
+
+SOURCES += main.cpp \
+    ../../PREF/platform/analysis/bytecounter.cpp
+
+HEADERS += ../../PREF/platform/analysis/bytecounter.h
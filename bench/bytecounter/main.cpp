@@ -0,0 +1,80 @@
+#include <platform/analysis/bytecounter.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static const uint64_t BUFFER_SIZE = 0x10000000; /* 256 MiB */
+static const int RUNS = 5;
+
+typedef void (*CountFunction)(uint64_t* counts, const unsigned char* data, uint64_t length);
+
+static void countSingleTable(uint64_t* counts, const unsigned char* data, uint64_t length)
+{
+    for(uint64_t i = 0; i < length; i++)
+        counts[data[i]]++;
+}
+
+static double measure(CountFunction countfunction, const std::vector<unsigned char>& buffer, uint64_t* total)
+{
+    double best = 0;
+
+    for(int i = 0; i < RUNS; i++)
+    {
+        uint64_t counts[256];
+        std::memset(counts, 0, sizeof(counts));
+
+        auto start = std::chrono::steady_clock::now();
+        countfunction(counts, buffer.data(), buffer.size());
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        *total = 0;
+
+        for(int j = 0; j < 256; j++) /* Also keeps the counts alive */
+            *total += counts[j];
+
+        double gbs = (buffer.size() / elapsed.count()) / 1e9;
+
+        if(gbs > best)
+            best = gbs;
+    }
+
+    return best;
+}
+
+int main(int, char**)
+{
+    std::vector<unsigned char> random(BUFFER_SIZE), zeros(BUFFER_SIZE, 0), text(BUFFER_SIZE);
+    uint32_t seed = 0x12345678;
+
+    for(uint64_t i = 0; i < BUFFER_SIZE; i++)
+    {
+        seed = (seed * 1103515245) + 12345;
+        random[i] = static_cast<unsigned char>(seed >> 24);
+        text[i] = static_cast<unsigned char>('a' + ((seed >> 24) % 4)); /* Few distinct values: worst case for a single table */
+    }
+
+    struct { const char* Name; const std::vector<unsigned char>* Buffer; } inputs[] = { { "random", &random }, { "4 values", &text }, { "zeros", &zeros } };
+    struct { const char* Name; CountFunction Function; } kernels[] = { { "single table", &countSingleTable }, { "ByteCounter", &ByteCounter::count } };
+
+    std::printf("%-10s %-14s %10s\n", "Input", "Kernel", "GB/s");
+
+    for(const auto& input : inputs)
+    {
+        for(const auto& kernel : kernels)
+        {
+            uint64_t total = 0;
+            double gbs = measure(kernel.Function, *input.Buffer, &total);
+
+            if(total != BUFFER_SIZE)
+            {
+                std::fprintf(stderr, "%s miscounted %s: %llu bytes\n", kernel.Name, input.Name, static_cast<unsigned long long>(total));
+                return 1;
+            }
+
+            std::printf("%-10s %-14s %10.2f\n", input.Name, kernel.Name, gbs);
+        }
+    }
+
+    return 0;
+}
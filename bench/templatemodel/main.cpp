@@ -0,0 +1,120 @@
+#include <models/templatemodel.h>
+#include <widgets/logwidget/logwidget.h>
+#include <QApplication>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QVector>
+#include <QFile>
+#include <QtEndian>
+#include <cstdio>
+
+static const int ENTRY_COUNT = 1000000;
+static const int DISPLAY_ROWS = 100000; /* What a ResizeToContents pass asks for */
+
+static bool writeFiles(const QString& btfile, const QString& datafile)
+{
+    QFile bt(btfile), data(datafile);
+
+    if(!bt.open(QFile::WriteOnly) || !data.open(QFile::WriteOnly))
+        return false;
+
+    /* One array with ENTRY_COUNT siblings, each holding a field: parent() of a field needs its element's row */
+    bt.write(QString("typedef struct { uint32 value; } ENTRY;\nENTRY entries[%1];\n").arg(ENTRY_COUNT).toUtf8());
+
+    QByteArray values(ENTRY_COUNT * sizeof(quint32), 0);
+
+    for(int i = 0; i < ENTRY_COUNT; i++)
+        qToLittleEndian<quint32>(static_cast<quint32>(i), reinterpret_cast<uchar*>(values.data()) + (i * sizeof(quint32)));
+
+    return data.write(values) == values.size();
+}
+
+static void report(const char* name, qint64 nsecs, int calls)
+{
+    std::printf("%-24s %10.2f ms %10.1f ns/call\n", name, nsecs / 1e6, static_cast<double>(nsecs) / calls);
+}
+
+int main(int argc, char** argv)
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    QTemporaryDir tempdir;
+    QString btfile = tempdir.filePath("synthetic.bt"), datafile = tempdir.filePath("synthetic.bin");
+
+    if(!tempdir.isValid() || !writeFiles(btfile, datafile))
+    {
+        std::fprintf(stderr, "Cannot write the synthetic template\n");
+        return 1;
+    }
+
+    QHexEdit hexedit;
+    LogWidget logwidget;
+    hexedit.setDocument(QHexDocument::fromFile(datafile));
+
+    TemplateModel model(&hexedit);
+    QEventLoop loop;
+    QElapsedTimer timer;
+
+    QObject::connect(&model, &TemplateModel::executionFinished, &loop, &QEventLoop::quit);
+
+    timer.start();
+    model.execute(btfile, &logwidget);
+
+    if(model.isExecuting())
+        loop.exec();
+
+    std::printf("%-24s %10.2f ms\n", "execute()", timer.nsecsElapsed() / 1e6);
+
+    QModelIndex array = model.index(0, 0, QModelIndex());
+
+    if(model.rowCount(array) != ENTRY_COUNT)
+    {
+        std::fprintf(stderr, "Unexpected tree: %d elements\n", model.rowCount(array));
+        return 1;
+    }
+
+    QVector<QModelIndex> elements(ENTRY_COUNT), fields(ENTRY_COUNT);
+
+    timer.restart();
+
+    for(int i = 0; i < ENTRY_COUNT; i++)
+    {
+        elements[i] = model.index(i, 0, array);
+        fields[i] = model.index(0, 0, elements[i]);
+    }
+
+    report("index()", timer.nsecsElapsed(), ENTRY_COUNT * 2);
+
+    int mismatches = 0;
+    timer.restart();
+
+    for(int i = 0; i < ENTRY_COUNT; i++) /* Every element is looked up among all of its siblings */
+    {
+        if(model.parent(fields[i]) != elements[i])
+            mismatches++;
+    }
+
+    report("parent()", timer.nsecsElapsed(), ENTRY_COUNT);
+
+    if(mismatches)
+    {
+        std::fprintf(stderr, "parent() returned the wrong row %d times\n", mismatches);
+        return 1;
+    }
+
+    const char* passes[] = { "data() formatting", "data() cached" };
+    int length = 0;
+
+    for(const char* pass : passes) /* The first pass fills the value cache, the second one reads it */
+    {
+        timer.restart();
+
+        for(int i = 0; i < DISPLAY_ROWS; i++)
+            length += model.data(fields[i].sibling(0, 1), Qt::DisplayRole).toString().length();
+
+        report(pass, timer.nsecsElapsed(), DISPLAY_ROWS);
+    }
+
+    return length ? 0 : 1;
+}
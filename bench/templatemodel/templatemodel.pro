@@ -0,0 +1,59 @@
+#-------------------------------------------------
+#
+# Template tree navigation and value display on a
+# synthetic 1M entry template, run it in release mode
+#
+#-------------------------------------------------
+
+QT       += core gui widgets concurrent
+
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TARGET = templatemodel_bench
+TEMPLATE = app
+
+PREF_DIR = $$PWD/../../PREF
+
+include($$PREF_DIR/qhexedit/QHexEdit.pri)
+
+INCLUDEPATH += $$PREF_DIR $$PWD/../../PrefLib
+
+unix: LIBS += -L$$OUT_PWD/../../PrefLib/ -lPrefLib
+win32: LIBS += -L$$OUT_PWD/../../PrefLib/release -lPrefLib
+
+SOURCES += main.cpp \
+    $$PREF_DIR/models/basicmodel.cpp \
+    $$PREF_DIR/models/templatemodel.cpp \
+    $$PREF_DIR/platform/arrayview.cpp \
+    $$PREF_DIR/platform/basicworker.cpp \
+    $$PREF_DIR/platform/btvmex.cpp \
+    $$PREF_DIR/platform/datadecoder.cpp \
+    $$PREF_DIR/platform/highlighttable.cpp \
+    $$PREF_DIR/platform/loadeddata.cpp \
+    $$PREF_DIR/platform/mappedfile.cpp \
+    $$PREF_DIR/platform/templatecache.cpp \
+    $$PREF_DIR/platform/templateexporter.cpp \
+    $$PREF_DIR/platform/templateprofiler.cpp \
+    $$PREF_DIR/platform/templateresult.cpp \
+    $$PREF_DIR/platform/templateworker.cpp \
+    $$PREF_DIR/widgets/logwidget/logwidget.cpp \
+    $$PREF_DIR/widgets/logwidget/loghighlighter.cpp
+
+HEADERS += \
+    $$PREF_DIR/models/basicmodel.h \
+    $$PREF_DIR/models/templatemodel.h \
+    $$PREF_DIR/platform/arrayview.h \
+    $$PREF_DIR/platform/basicworker.h \
+    $$PREF_DIR/platform/btvmex.h \
+    $$PREF_DIR/platform/datadecoder.h \
+    $$PREF_DIR/platform/highlighttable.h \
+    $$PREF_DIR/platform/loadeddata.h \
+    $$PREF_DIR/platform/mappedfile.h \
+    $$PREF_DIR/platform/templatecache.h \
+    $$PREF_DIR/platform/templateexporter.h \
+    $$PREF_DIR/platform/templateprofiler.h \
+    $$PREF_DIR/platform/templateresult.h \
+    $$PREF_DIR/platform/templateworker.h \
+    $$PREF_DIR/widgets/logwidget/logwidget.h \
+    $$PREF_DIR/widgets/logwidget/loghighlighter.h